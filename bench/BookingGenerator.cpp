@@ -0,0 +1,217 @@
+#include "BookingGenerator.h"
+
+#include "BinaryBookingWriter.h"
+#include "Booking.h"
+#include "BookingArena.h"
+#include "BookingStore.h"
+#include "Date.h"
+#include "ReportWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace {
+constexpr std::size_t kBatchSize = 16 * 1024;
+
+constexpr std::array<std::string_view, 16> kAirports = {"FRA", "MUC", "BER", "HAM", "DUS", "CGN", "STR", "JFK",
+                                                        "LHR", "CDG", "AMS", "MAD", "FCO", "VIE", "ZRH", "IST"};
+constexpr std::array<std::string_view, 8> kAirlines = {"Lufthansa", "Condor",     "Eurowings", "Ryanair",
+                                                       "KLM",       "Air France", "easyJet",   "Swiss"};
+constexpr std::array<std::string_view, 12> kCities = {"Berlin", "Paris",   "Rom",    "Wien",   "Madrid",    "London",
+                                                      "Prag",   "Hamburg", "Zürich", "Lissabon", "Amsterdam", "Budapest"};
+constexpr std::array<std::string_view, 10> kHotels = {"Hilton",  "Ibis",     "Maritim",   "Adlon",      "Motel One",
+                                                      "Marriott", "Radisson", "Steigenberger", "NH Hotel", "Holiday Inn"};
+constexpr std::array<std::string_view, 6> kCompanies = {"Sixt", "Hertz", "Avis", "Europcar", "Enterprise", "Budget"};
+constexpr std::array<std::string_view, 20> kStations = {
+    "Darmstadt Hbf", "Frankfurt Hbf", "Mannheim Hbf", "Köln Hbf",     "Berlin Hbf",   "Hamburg Hbf", "München Hbf",
+    "Stuttgart Hbf", "Hannover Hbf",  "Leipzig Hbf",  "Dresden Hbf",  "Nürnberg Hbf", "Karlsruhe",   "Freiburg",
+    "Kassel-Wilh.",  "Fulda",         "Würzburg Hbf", "Erfurt Hbf",   "Dortmund Hbf", "Bremen Hbf"};
+
+class RandomBookings {
+public:
+    explicit RandomBookings(std::uint64_t seed) : random_(seed) {}
+
+    BookingPtr next(BookingArena &arena) {
+        std::string_view id = arena.copy(nextId());
+        const double price = static_cast<double>(uniform(1000, 250000)) / 100.0;
+        const DayNumber fromDate = firstDay_ + static_cast<DayNumber>(uniform(0, 3 * 365));
+        const DayNumber toDate = fromDate + static_cast<DayNumber>(uniform(0, 21));
+
+        switch (uniform(0, 3)) {
+        case 0: {
+            std::string_view from = pick(kAirports);
+            std::string_view to = pick(kAirports);
+            return arena.create<FlightBooking>(id, price, fromDate, toDate, from, to, pick(kAirlines));
+        }
+        case 1: {
+            std::string_view hotel = pick(kHotels);
+            return arena.create<HotelReservation>(id, price, fromDate, toDate, hotel, pick(kCities));
+        }
+        case 2: {
+            std::string_view pickup = pick(kCities);
+            std::string_view dropoff = uniform(0, 3) == 0 ? pick(kCities) : pickup;
+            return arena.create<RentalCarReservation>(id, price, fromDate, toDate, pickup, dropoff, pick(kCompanies));
+        }
+        default:
+            break;
+        }
+
+        // A route of distinct stations: departure, zero to four via stations, arrival.
+        std::array<std::string_view, kStations.size()> stations = kStations;
+        const std::size_t viaCount = uniform(0, 4);
+        for (std::size_t i = 0; i < viaCount + 2; ++i) {
+            std::swap(stations[i], stations[uniform(i, stations.size() - 1)]);
+        }
+        std::pmr::vector<std::string_view> via(stations.begin() + 1, stations.begin() + 1 + viaCount,
+                                               arena.resource());
+        std::string_view departure = nextTime(arena);
+        std::string_view arrival = nextTime(arena);
+        return arena.create<TrainTicket>(id, price, fromDate, toDate, stations[0], stations[viaCount + 1], departure,
+                                         arrival, std::move(via));
+    }
+
+private:
+    std::size_t uniform(std::size_t min, std::size_t max) {
+        return std::uniform_int_distribution<std::size_t>(min, max)(random_);
+    }
+
+    template <std::size_t N>
+    std::string_view pick(const std::array<std::string_view, N> &values) {
+        return values[uniform(0, N - 1)];
+    }
+
+    // Random version 4 UUID text, as the production feeds use.
+    std::string_view nextId() {
+        static constexpr char kHex[] = "0123456789abcdef";
+        for (std::size_t i = 0; i < idText_.size(); ++i) {
+            idText_[i] = kHex[uniform(0, 15)];
+        }
+        idText_[8] = idText_[13] = idText_[18] = idText_[23] = '-';
+        idText_[14] = '4';
+        idText_[19] = kHex[8 + uniform(0, 3)];
+        return std::string_view(idText_.data(), idText_.size());
+    }
+
+    std::string_view nextTime(BookingArena &arena) {
+        const std::size_t hour = uniform(0, 23);
+        const std::size_t minute = uniform(0, 59);
+        const char text[] = {static_cast<char>('0' + hour / 10), static_cast<char>('0' + hour % 10), ':',
+                             static_cast<char>('0' + minute / 10), static_cast<char>('0' + minute % 10)};
+        return arena.copy(std::string_view(text, sizeof(text)));
+    }
+
+    std::mt19937_64 random_;
+    const DayNumber firstDay_ = daysFromCivil(2024, 1, 1);
+    std::array<char, 36> idText_{};
+};
+
+// Writes one booking per line as a compact JSON object.
+class JsonBookingWriter {
+public:
+    explicit JsonBookingWriter(ReportWriter &out) : out_(out) {}
+
+    void operator()(const FlightBooking &booking) {
+        common("Flight", booking);
+        field("fromAirport", booking.getFromAirport());
+        field("toAirport", booking.getToAirport());
+        field("airline", booking.getAirline());
+        out_.write('}');
+    }
+
+    void operator()(const HotelReservation &booking) {
+        common("Hotel", booking);
+        field("hotel", booking.getHotel());
+        field("city", booking.getCity());
+        out_.write('}');
+    }
+
+    void operator()(const RentalCarReservation &booking) {
+        common("RentalCar", booking);
+        field("pickupLocation", booking.getPickupLocation());
+        field("returnLocation", booking.getReturnLocation());
+        field("company", booking.getCompany());
+        out_.write('}');
+    }
+
+    void operator()(const TrainTicket &booking) {
+        common("Train", booking);
+        field("fromStation", booking.getFromStation());
+        field("toStation", booking.getToStation());
+        field("departureTime", booking.getDepartureTime());
+        field("arrivalTime", booking.getArrivalTime());
+        out_.write(",\"viaStations\":[");
+        const char *separator = "";
+        for (std::string_view station : booking.getViaStations()) {
+            out_.write(separator).write('"').write(station).write('"');
+            separator = ",";
+        }
+        out_.write("]}");
+    }
+
+private:
+    // The generated text never needs escaping.
+    void common(std::string_view type, const Booking &booking) {
+        out_.write(first_ ? "  {" : ",\n  {");
+        first_ = false;
+        out_.write("\"id\":\"").write(booking.getId()).write("\",\"price\":").writeFixed(booking.getPrice());
+        out_.write(",\"fromDate\":\"").writeIsoDate(booking.getFromDate());
+        out_.write("\",\"toDate\":\"").writeIsoDate(booking.getToDate()).write('"');
+        field("type", type);
+    }
+
+    void field(std::string_view name, std::string_view value) {
+        out_.write(",\"").write(name).write("\":\"").write(value).write('"');
+    }
+
+    ReportWriter &out_;
+    bool first_ = true;
+};
+
+void openOutput(std::ofstream &out, const std::string &path) {
+    out.open(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Could not open output file: " + path);
+    }
+}
+} // namespace
+
+void generateBookings(const GeneratorOptions &options, const std::string &jsonPath, const std::string &binaryPath) {
+    std::ofstream jsonFile;
+    std::ofstream binaryFile;
+    openOutput(jsonFile, jsonPath);
+    openOutput(binaryFile, binaryPath);
+
+    RandomBookings random(options.seed);
+    BookingArena arena;
+    std::vector<BookingPtr> batch;
+    BookingStore store;
+    {
+        ReportWriter json(jsonFile);
+        JsonBookingWriter writer(json);
+        json.write("[\n");
+        for (std::size_t done = 0; done < options.records;) {
+            const std::size_t count = std::min(kBatchSize, options.records - done);
+            for (std::size_t i = 0; i < count; ++i) {
+                batch.push_back(random.next(arena));
+                store.append(*batch.back());
+            }
+            store.forEach(writer);
+            writeBinaryBookings(store, binaryFile, BinaryFormat::FixedWidth);
+
+            store.clear();
+            batch.clear();
+            arena.release();
+            done += count;
+        }
+        json.write("\n]\n");
+        json.flush();
+    }
+    if (!jsonFile.flush() || !binaryFile.flush()) {
+        throw std::runtime_error("Could not write generated bookings.");
+    }
+}
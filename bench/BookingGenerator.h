@@ -0,0 +1,20 @@
+#ifndef BOOKINGGENERATOR_H
+#define BOOKINGGENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct GeneratorOptions {
+    std::size_t records = 1000;
+    std::uint64_t seed = 1;
+};
+
+// Writes the same `options.records` synthetic bookings as a JSON array to `jsonPath` and in the
+// fixed-width binary format to `binaryPath`. All four kinds occur about equally often; train
+// tickets have zero to four via stations. Equal options produce identical files with the same
+// standard library (the random distributions are implementation-defined). Memory use does
+// not depend on the record count. Throws std::runtime_error if a file cannot be written.
+void generateBookings(const GeneratorOptions &options, const std::string &jsonPath, const std::string &binaryPath);
+
+#endif // BOOKINGGENERATOR_H
@@ -0,0 +1,304 @@
+// Load benchmark for TravelAgency.
+//
+//   TravelAgencyBench [--sizes 1000,100000,...] [--repeat N] [--threads N] [--seed S] [--dir DIR] [--keep]
+//   TravelAgencyBench --generate <records> <out.json> <out.bin> [--seed S]
+//
+// For every size the benchmark generates a dataset, then times each operation and prints one JSON
+// object per line to stdout:
+//
+//   {"operation":"readFile","variant":"json","records":1000,"bytes":...,"repeat":3,"seconds":...,
+//    "recordsPerSecond":...,"megabytesPerSecond":...,"peakRssBytes":...,"allocations":...,
+//    "allocatedBytes":...}
+//
+// "seconds" is the fastest of the repeated runs; the allocation counts and the peak resident set
+// size belong to that run. Progress and errors go to stderr.
+
+#include "AllocationCounter.h"
+#include "BookingGenerator.h"
+#include "ReportWriter.h"
+#include "TravelAgency.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "json.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace {
+struct BenchmarkOptions {
+    std::vector<std::size_t> sizes = {1000, 10000, 100000, 1000000};
+    std::size_t repeat = 3;
+    std::size_t threads = 0;
+    std::uint64_t seed = 1;
+    std::filesystem::path directory = std::filesystem::temp_directory_path();
+    bool keepFiles = false;
+};
+
+struct Measurement {
+    double seconds = std::numeric_limits<double>::infinity();
+    std::uint64_t peakRssBytes = 0;
+    AllocationCounts allocations;
+};
+
+// Discards everything written to it and counts the bytes.
+class CountingBuffer : public std::streambuf {
+public:
+    std::uint64_t count() const { return count_; }
+
+protected:
+    std::streamsize xsputn(const char *, std::streamsize size) override {
+        count_ += static_cast<std::uint64_t>(size);
+        return size;
+    }
+
+    int_type overflow(int_type ch) override {
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            ++count_;
+        }
+        return traits_type::not_eof(ch);
+    }
+
+private:
+    std::uint64_t count_ = 0;
+};
+
+// Starts a new peak resident set size measurement. Only Linux can reset the high-water mark;
+// elsewhere the peak is that of the whole process so far.
+void resetPeakRss() {
+#ifdef __linux__
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+#endif
+}
+
+std::uint64_t peakRssBytes() {
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::stoull(line.substr(6)) * 1024;
+        }
+    }
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<std::uint64_t>(usage.ru_maxrss);
+#else
+    return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+    return 0;
+#endif
+}
+
+Measurement measure(std::size_t repeat, const std::function<void()> &setUp, const std::function<void()> &run) {
+    Measurement best;
+    for (std::size_t i = 0; i < repeat; ++i) {
+        setUp();
+        resetPeakRss();
+        const AllocationCounts before = allocationCounts();
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const auto end = std::chrono::steady_clock::now();
+        const AllocationCounts allocations = allocationCounts() - before;
+        const double seconds = std::chrono::duration<double>(end - start).count();
+        if (seconds < best.seconds) {
+            best = {seconds, peakRssBytes(), allocations};
+        }
+    }
+    return best;
+}
+
+void report(const std::string &operation, const std::string &variant, std::size_t records, std::uint64_t bytes,
+            std::size_t repeat, const Measurement &measurement) {
+    const double seconds = std::max(measurement.seconds, 1e-9);
+    nlohmann::ordered_json line = {
+        {"operation", operation},
+        {"variant", variant},
+        {"records", records},
+        {"bytes", bytes},
+        {"repeat", repeat},
+        {"seconds", measurement.seconds},
+        {"recordsPerSecond", static_cast<double>(records) / seconds},
+        {"megabytesPerSecond", static_cast<double>(bytes) / seconds / 1e6},
+        {"peakRssBytes", measurement.peakRssBytes},
+        {"allocations", measurement.allocations.allocations},
+        {"allocatedBytes", measurement.allocations.bytes},
+    };
+    std::cout << line.dump() << std::endl;
+}
+
+void runSize(const BenchmarkOptions &options, std::size_t records) {
+    namespace fs = std::filesystem;
+    const std::string stem = "travelagency-bench-" + std::to_string(records);
+    const fs::path jsonPath = options.directory / (stem + ".json");
+    const fs::path fixedPath = options.directory / (stem + ".bin");
+    const fs::path indexedPath = options.directory / (stem + ".v2.bin");
+
+    std::cerr << "Generating " << records << " bookings in " << options.directory.string() << "\n";
+    generateBookings({records, options.seed}, jsonPath.string(), fixedPath.string());
+    {
+        TravelAgency agency;
+        agency.readBinaryFile(fixedPath.string());
+        agency.writeBinaryFile(indexedPath.string(), BinaryFormat::Indexed);
+    }
+
+    const std::size_t repeat = options.repeat;
+    std::optional<TravelAgency> agency;
+    auto fresh = [&agency]() { agency.emplace(); };
+    LoadOptions serial;
+    LoadOptions parallel;
+    parallel.parallel = true;
+    parallel.threadCount = options.threads;
+
+    struct Load {
+        const char *operation;
+        const char *variant;
+        const fs::path &path;
+        const LoadOptions &loadOptions;
+    };
+    const Load loads[] = {
+        {"readFile", "json", jsonPath, serial},
+        {"readFile", "json-parallel", jsonPath, parallel},
+        {"readBinaryFile", "fixed-width", fixedPath, serial},
+        {"readBinaryFile", "fixed-width-parallel", fixedPath, parallel},
+        {"readBinaryFile", "indexed", indexedPath, serial},
+        {"readBinaryFile", "indexed-parallel", indexedPath, parallel},
+    };
+    for (const Load &load : loads) {
+        const std::string path = load.path.string();
+        const bool json = std::string(load.operation) == "readFile";
+        Measurement measurement = measure(repeat, fresh, [&]() {
+            if (json) {
+                agency->readFile(path, load.loadOptions);
+            } else {
+                agency->readBinaryFile(path, load.loadOptions);
+            }
+        });
+        report(load.operation, load.variant, records, fs::file_size(load.path), repeat, measurement);
+    }
+
+    // The remaining operations work on the bookings of the last load.
+    std::vector<std::string> ids;
+    ids.reserve(2 * agency->size());
+    agency->visitBookings([&ids](const Booking &booking) {
+        ids.emplace_back(booking.getId());
+        // Same length, never generated: the UUIDs contain no 'x'.
+        ids.emplace_back(std::string(booking.getId()).replace(0, 1, "x"));
+    });
+    std::size_t found = 0;
+    Measurement lookups = measure(repeat, [&found]() { found = 0; }, [&]() {
+        for (const std::string &id : ids) {
+            found += agency->existsId(id) ? 1 : 0;
+        }
+    });
+    if (found != agency->size()) {
+        throw std::runtime_error("existsId found " + std::to_string(found) + " of " +
+                                 std::to_string(agency->size()) + " ids.");
+    }
+    report("existsId", "half-hits", ids.size(), 0, repeat, lookups);
+
+    auto reportOutput = [&](const char *operation, const std::function<void(ReportWriter &)> &print) {
+        std::uint64_t bytes = 0;
+        Measurement measurement = measure(repeat, []() {}, [&]() {
+            CountingBuffer buffer;
+            std::ostream sink(&buffer);
+            {
+                ReportWriter out(sink);
+                print(out);
+            }
+            bytes = buffer.count();
+        });
+        report(operation, "discard", records, bytes, repeat, measurement);
+    };
+    reportOutput("printAllDetails", [&](ReportWriter &out) { agency->printAllDetails(out); });
+    reportOutput("printStatistics", [&](ReportWriter &out) { agency->printStatistics(out); });
+
+    agency.reset();
+    if (!options.keepFiles) {
+        fs::remove(jsonPath);
+        fs::remove(fixedPath);
+        fs::remove(indexedPath);
+    }
+}
+
+std::vector<std::size_t> parseSizes(const std::string &text) {
+    std::vector<std::size_t> sizes;
+    std::size_t start = 0;
+    while (start <= text.size()) {
+        std::size_t end = text.find(',', start);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        sizes.push_back(std::stoull(text.substr(start, end - start)));
+        start = end + 1;
+    }
+    return sizes;
+}
+
+int usage(const char *program) {
+    std::cerr << "Usage: " << program
+              << " [--sizes N,N,...] [--repeat N] [--threads N] [--seed S] [--dir DIR] [--keep]\n"
+              << "       " << program << " --generate <records> <out.json> <out.bin> [--seed S]\n";
+    return 2;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    try {
+        BenchmarkOptions options;
+        std::vector<std::string> generate;
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument = argv[i];
+            const bool hasValue = i + 1 < argc;
+            if (argument == "--sizes" && hasValue) {
+                options.sizes = parseSizes(argv[++i]);
+            } else if (argument == "--repeat" && hasValue) {
+                options.repeat = std::max<std::size_t>(1, std::stoull(argv[++i]));
+            } else if (argument == "--threads" && hasValue) {
+                options.threads = std::stoull(argv[++i]);
+            } else if (argument == "--seed" && hasValue) {
+                options.seed = std::stoull(argv[++i]);
+            } else if (argument == "--dir" && hasValue) {
+                options.directory = argv[++i];
+            } else if (argument == "--keep") {
+                options.keepFiles = true;
+            } else if (argument == "--generate" && i + 3 < argc) {
+                generate.assign(argv + i + 1, argv + i + 4);
+                i += 3;
+            } else {
+                return usage(argv[0]);
+            }
+        }
+
+        if (!generate.empty()) {
+            generateBookings({std::stoull(generate[0]), options.seed}, generate[1], generate[2]);
+            return 0;
+        }
+        for (std::size_t records : options.sizes) {
+            runSize(options, records);
+        }
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
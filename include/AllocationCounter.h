@@ -0,0 +1,25 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Totals of the global operator new calls made so far by the whole process. They stay zero unless
+// the program links AllocationHook.cpp, which replaces the global allocation functions; the core
+// library never does.
+struct AllocationCounts {
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes = 0;
+};
+
+AllocationCounts allocationCounts();
+
+// Counts one allocation on the calling thread. Every thread counts into its own cache line, so
+// parallel loads do not contend; allocationCounts() sums the threads.
+void countAllocation(std::size_t bytes);
+
+inline AllocationCounts operator-(const AllocationCounts &a, const AllocationCounts &b) {
+    return {a.allocations - b.allocations, a.bytes - b.bytes};
+}
+
+#endif // ALLOCATIONCOUNTER_H
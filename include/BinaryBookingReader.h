@@ -0,0 +1,84 @@
+#ifndef BINARYBOOKINGREADER_H
+#define BINARYBOOKINGREADER_H
+
+#include "BinaryCursor.h"
+#include "BookingArena.h"
+#include "Booking.h"
+#include "StringPool.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Field widths of the fixed-width binary booking format.
+constexpr std::size_t kBinaryIdLength = 38;
+constexpr std::size_t kBinaryDateLength = 8;
+constexpr std::size_t kBinaryAirportLength = 3;
+constexpr std::size_t kBinaryTextLength = 15;
+constexpr std::size_t kBinaryTimeLength = 5;
+// Type tag, id, price and both dates.
+constexpr std::size_t kBinaryCommonLength = 1 + kBinaryIdLength + sizeof(double) + 2 * kBinaryDateLength;
+
+// Returns the size of the record starting at `data` without decoding it, or 0 if the record is
+// truncated, has an unknown type tag or a negative via station count.
+std::size_t binaryRecordSize(const char *data, std::size_t available);
+
+// True if `data` holds the start of a well-formed record that ends past `available`, as the last
+// record of a file that is still being appended to.
+bool isIncompleteBinaryRecord(const char *data, std::size_t available);
+
+// Decodes the record at the cursor. `checkId` receives the id right after the empty-id check and
+// before any further field is read, so callers can reject duplicates in the documented order.
+// The booking is built in `arena`; repeated text attributes are interned in `strings`.
+BookingPtr readBinaryRecord(BinaryCursor &in, const std::function<void(std::string_view)> &checkId,
+                            BookingArena &arena, StringPool &strings);
+
+// Indexed binary format (version 2). All integers and doubles are in host byte order, as in the
+// fixed-width format.
+//
+//   header        magic "BKNG", uint32 version, uint64 record count, uint64 string table offset,
+//                 uint64 index offset
+//   records       type tag, then the fields of the fixed-width format in the same order, with
+//                 every string replaced by a uint32 string table reference and the via station
+//                 count stored as uint32
+//   string table  uint32 count, count x (uint32 offset, uint32 length) into the bytes that follow
+//   index         uint64 file offset of every record, ending the file
+constexpr char kIndexedBinaryMagic[4] = {'B', 'K', 'N', 'G'};
+constexpr std::uint32_t kIndexedBinaryVersion = 2;
+constexpr std::size_t kIndexedBinaryHeaderLength = 4 + sizeof(std::uint32_t) + 3 * sizeof(std::uint64_t);
+
+// True if `data` starts like an indexed file. Fixed-width files start with a record type tag.
+bool isIndexedBinaryFile(const char *data, std::size_t size);
+
+// Validated header, string table and index of an indexed file. Views point into the file data.
+class IndexedBinaryFile {
+public:
+    // Throws std::runtime_error if the header, string table or index are inconsistent.
+    IndexedBinaryFile(const char *data, std::size_t size);
+
+    std::size_t recordCount() const { return recordCount_; }
+    const std::vector<std::string_view> &strings() const { return strings_; }
+
+    // Bytes of record `index`, from its start up to the start of the next record.
+    BinaryCursor record(std::size_t index) const;
+
+private:
+    std::size_t recordOffset(std::size_t index) const;
+
+    const char *data_;
+    std::size_t recordCount_ = 0;
+    std::size_t stringTableOffset_ = 0;
+    const char *index_ = nullptr;
+    std::vector<std::string_view> strings_;
+};
+
+// Decodes record `index` of `file`. `checkId` is called as for readBinaryRecord. If `strings` is
+// null, the booking's text is not copied: it views the file data, which must outlive it.
+BookingPtr readIndexedBinaryRecord(const IndexedBinaryFile &file, std::size_t index,
+                                   const std::function<void(std::string_view)> &checkId, BookingArena &arena,
+                                   StringPool *strings);
+
+#endif // BINARYBOOKINGREADER_H
@@ -0,0 +1,19 @@
+#ifndef BINARYBOOKINGWRITER_H
+#define BINARYBOOKINGWRITER_H
+
+#include "BookingStore.h"
+
+#include <ostream>
+
+enum class BinaryFormat {
+    // Headerless records with space-padded fixed-width string slots, as read by readBinaryRecord.
+    // Throws std::runtime_error if an attribute does not fit its slot.
+    FixedWidth,
+    // Version 2 with header, string table and record index (see BinaryBookingReader.h).
+    Indexed,
+};
+
+// Writes all bookings of `store` in load order. `out` should be opened in binary mode.
+void writeBinaryBookings(const BookingStore &store, std::ostream &out, BinaryFormat format);
+
+#endif // BINARYBOOKINGWRITER_H
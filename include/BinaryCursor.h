@@ -0,0 +1,83 @@
+#ifndef BINARYCURSOR_H
+#define BINARYCURSOR_H
+
+#include "Booking.h"
+#include "FieldScan.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+// Sequential reader over the binary booking formats. Strings are returned as views into the
+// underlying bytes (trimmed for the fixed-width slots); nothing is copied.
+class BinaryCursor {
+public:
+    BinaryCursor(const char *begin, const char *end) : current_(begin), begin_(begin), end_(end) {}
+
+    bool atEnd() const { return current_ >= end_; }
+    std::size_t offset() const { return static_cast<std::size_t>(current_ - begin_); }
+    std::size_t remaining() const { return atEnd() ? 0 : static_cast<std::size_t>(end_ - current_); }
+    const char *position() const { return current_; }
+
+    void skip(std::size_t length) {
+        require(length);
+        current_ += length;
+    }
+
+    char readChar() {
+        require(1);
+        return *current_++;
+    }
+
+    std::string_view readFixedString(std::size_t length) {
+        require(length);
+        std::string_view value = trimPaddedSlot(current_, length, static_cast<std::size_t>(end_ - current_));
+        current_ += length;
+        return value;
+    }
+
+    double readDouble() {
+        double value = 0.0;
+        readRaw(&value, sizeof(double));
+        return value;
+    }
+
+    std::int32_t readInt32() {
+        std::int32_t value = 0;
+        readRaw(&value, sizeof(std::int32_t));
+        return value;
+    }
+
+    std::uint32_t readUInt32() {
+        std::uint32_t value = 0;
+        readRaw(&value, sizeof(std::uint32_t));
+        return value;
+    }
+
+    std::uint64_t readUInt64() {
+        std::uint64_t value = 0;
+        readRaw(&value, sizeof(std::uint64_t));
+        return value;
+    }
+
+private:
+    void require(std::size_t length) const {
+        if (static_cast<std::size_t>(end_ - current_) < length) {
+            throw std::runtime_error("Unexpected end of file while reading binary data.");
+        }
+    }
+
+    void readRaw(void *target, std::size_t length) {
+        require(length);
+        std::memcpy(target, current_, length);
+        current_ += length;
+    }
+
+    const char *current_;
+    const char *begin_;
+    const char *end_;
+};
+
+#endif // BINARYCURSOR_H
@@ -1,89 +1,126 @@
 #ifndef BOOKING_H
 #define BOOKING_H
 
+#include "Date.h"
+
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <memory_resource>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
-std::string formatDate(const std::string &isoDate);
+class ReportWriter;
+
 std::string formatPrice(double price);
-std::string joinStrings(const std::vector<std::string> &values, const std::string &separator);
-std::string trimSpaces(const std::string &value);
-bool isAirportCode(const std::string &code);
+std::string joinStrings(const std::pmr::vector<std::string_view> &values, const std::string &separator);
+std::string_view trimSpaces(std::string_view value);
+bool isAirportCode(std::string_view code);
+// "HH:MM" with hours 00-23 and minutes 00-59.
+bool isClockTime(std::string_view time);
+
+// Dates are validated day numbers. Bookings do not own their text: every string attribute is a
+// view. Bookings loaded through a TravelAgency live in its arena and point into its arena and
+// StringPool; other callers must keep the viewed strings alive for the lifetime of the booking.
+enum class BookingKind : std::uint8_t { Flight, Hotel, RentalCar, Train };
 
 class Booking {
 public:
-    Booking(std::string id, double price, std::string fromDate, std::string toDate);
+    Booking(BookingKind kind, std::string_view id, double price, DayNumber fromDate, DayNumber toDate);
     virtual ~Booking();
 
-    const std::string &getId() const { return id_; }
+    BookingKind kind() const { return kind_; }
+    std::string_view getId() const { return id_; }
     double getPrice() const { return price_; }
+    DayNumber getFromDate() const { return fromDate_; }
+    DayNumber getToDate() const { return toDate_; }
 
-    virtual void showDetails() const = 0;
+    // Writes the one-line description used by TravelAgency::printAllDetails.
+    virtual void writeDetails(ReportWriter &out) const = 0;
+    void showDetails() const;
 
 protected:
-    std::string id_;
+    BookingKind kind_;
+    std::string_view id_;
     double price_;
-    std::string fromDate_;
-    std::string toDate_;
+    DayNumber fromDate_;
+    DayNumber toDate_;
 };
 
 class FlightBooking : public Booking {
 public:
-    FlightBooking(std::string id, double price, std::string fromDate, std::string toDate,
-                  std::string fromAirport, std::string toAirport, std::string airline);
+    FlightBooking(std::string_view id, double price, DayNumber fromDate, DayNumber toDate,
+                  std::string_view fromAirport, std::string_view toAirport, std::string_view airline);
+
+    std::string_view getFromAirport() const { return fromAirport_; }
+    std::string_view getToAirport() const { return toAirport_; }
+    std::string_view getAirline() const { return airline_; }
 
-    void showDetails() const override;
+    void writeDetails(ReportWriter &out) const override;
 
 private:
-    std::string fromAirport_;
-    std::string toAirport_;
-    std::string airline_;
+    std::string_view fromAirport_;
+    std::string_view toAirport_;
+    std::string_view airline_;
 };
 
 class HotelReservation : public Booking {
 public:
-    HotelReservation(std::string id, double price, std::string fromDate, std::string toDate,
-                     std::string hotel, std::string city);
+    HotelReservation(std::string_view id, double price, DayNumber fromDate, DayNumber toDate,
+                     std::string_view hotel, std::string_view city);
 
-    void showDetails() const override;
+    std::string_view getHotel() const { return hotel_; }
+    std::string_view getCity() const { return city_; }
+
+    void writeDetails(ReportWriter &out) const override;
 
 private:
-    std::string hotel_;
-    std::string city_;
+    std::string_view hotel_;
+    std::string_view city_;
 };
 
 class RentalCarReservation : public Booking {
 public:
-    RentalCarReservation(std::string id, double price, std::string fromDate, std::string toDate,
-                         std::string pickupLocation, std::string returnLocation, std::string company);
+    RentalCarReservation(std::string_view id, double price, DayNumber fromDate, DayNumber toDate,
+                         std::string_view pickupLocation, std::string_view returnLocation,
+                         std::string_view company);
+
+    std::string_view getPickupLocation() const { return pickupLocation_; }
+    std::string_view getReturnLocation() const { return returnLocation_; }
+    std::string_view getCompany() const { return company_; }
 
-    void showDetails() const override;
+    void writeDetails(ReportWriter &out) const override;
 
 private:
-    std::string pickupLocation_;
-    std::string returnLocation_;
-    std::string company_;
+    std::string_view pickupLocation_;
+    std::string_view returnLocation_;
+    std::string_view company_;
 };
 
 class TrainTicket : public Booking {
 public:
-    TrainTicket(std::string id, double price, std::string fromDate, std::string toDate,
-                std::string fromStation, std::string toStation,
-                std::string departureTime, std::string arrivalTime,
-                std::vector<std::string> viaStations);
+    TrainTicket(std::string_view id, double price, DayNumber fromDate, DayNumber toDate,
+                std::string_view fromStation, std::string_view toStation,
+                std::string_view departureTime, std::string_view arrivalTime,
+                std::pmr::vector<std::string_view> viaStations);
+
+    std::string_view getFromStation() const { return fromStation_; }
+    std::string_view getToStation() const { return toStation_; }
+    std::string_view getDepartureTime() const { return departureTime_; }
+    std::string_view getArrivalTime() const { return arrivalTime_; }
+    const std::pmr::vector<std::string_view> &getViaStations() const { return viaStations_; }
 
-    void showDetails() const override;
+    void writeDetails(ReportWriter &out) const override;
 
 private:
-    std::string fromStation_;
-    std::string toStation_;
-    std::string departureTime_;
-    std::string arrivalTime_;
-    std::vector<std::string> viaStations_;
+    std::string_view fromStation_;
+    std::string_view toStation_;
+    std::string_view departureTime_;
+    std::string_view arrivalTime_;
+    std::pmr::vector<std::string_view> viaStations_;
 };
 
 #endif // BOOKING_H
@@ -0,0 +1,58 @@
+#ifndef BOOKINGARENA_H
+#define BOOKINGARENA_H
+
+#include "Booking.h"
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <string_view>
+#include <utility>
+
+// Destroys an arena-allocated object without freeing its memory; the arena releases it later.
+struct ArenaDeleter {
+    template <class T>
+    void operator()(T *object) const {
+        object->~T();
+    }
+};
+
+using BookingPtr = std::unique_ptr<Booking, ArenaDeleter>;
+
+// Monotonic arena for bookings and the text they own (their ids). Allocation is a pointer
+// bump; everything is returned to the heap at once by release(). Not thread-safe: concurrent
+// loaders use one arena per worker.
+class BookingArena {
+public:
+    explicit BookingArena(std::size_t initialSize = 64 * 1024) : resource_(initialSize) {}
+
+    BookingArena(const BookingArena &) = delete;
+    BookingArena &operator=(const BookingArena &) = delete;
+
+    template <class T, class... Args>
+    BookingPtr create(Args &&...args) {
+        void *memory = resource_.allocate(sizeof(T), alignof(T));
+        return BookingPtr(new (memory) T(std::forward<Args>(args)...));
+    }
+
+    std::string_view copy(std::string_view text) {
+        if (text.empty()) {
+            return {};
+        }
+        auto *target = static_cast<char *>(resource_.allocate(text.size(), 1));
+        std::memcpy(target, text.data(), text.size());
+        return {target, text.size()};
+    }
+
+    std::pmr::memory_resource *resource() { return &resource_; }
+
+    // All objects created in the arena must have been destroyed before.
+    void release() { resource_.release(); }
+
+private:
+    std::pmr::monotonic_buffer_resource resource_;
+};
+
+#endif // BOOKINGARENA_H
@@ -0,0 +1,37 @@
+#ifndef BOOKINGEXPORT_H
+#define BOOKINGEXPORT_H
+
+#include "BookingStore.h"
+#include "ReportWriter.h"
+
+#include <cstddef>
+
+enum class ExportFormat {
+    // A JSON array with one object per booking in the layout readFile reads. Prices are written
+    // as the shortest text that reads back as the same double.
+    Json,
+    // CSV after RFC 4180 with a header row and one column per attribute of any booking kind,
+    // empty where the kind has no such attribute. Via stations are joined with '|'; a '|' or '\'
+    // in a station name is preceded by a '\'.
+    Csv,
+};
+
+struct ExportOptions {
+    // Format chunks of bookings on a thread pool and write them in order. The output is the same
+    // as for a sequential export.
+    bool parallel = false;
+    // Worker threads for parallel exports; 0 uses std::thread::hardware_concurrency().
+    std::size_t threadCount = 0;
+};
+
+// Throws std::runtime_error naming the first booking with an empty id or string attribute, or
+// with text that is not valid UTF-8. readFile rejects those, and binary files may contain them,
+// so a JSON export of such a store would not read back.
+void validateJsonExport(const BookingStore &store);
+
+// Writes all bookings of `store` in load order, straight from the bookings without a DOM. Does
+// not validate; call validateJsonExport first if the JSON must read back through readFile.
+void exportBookings(const BookingStore &store, ReportWriter &out, ExportFormat format,
+                    const ExportOptions &options = {});
+
+#endif // BOOKINGEXPORT_H
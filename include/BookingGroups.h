@@ -0,0 +1,37 @@
+#ifndef BOOKINGGROUPS_H
+#define BOOKINGGROUPS_H
+
+#include "BookingStore.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class GroupBy {
+    Airline,
+    HotelCity,
+    RentalCompany,
+    // Departure and arrival of flights and train tickets, as "Flight: <from> -> <to>" and
+    // "Train: <from> -> <to>".
+    Route,
+    // Month of fromDate over all bookings, as "YYYY-MM".
+    Month,
+};
+
+// Accepts "airline", "city", "company", "route" and "month".
+bool parseGroupBy(std::string_view name, GroupBy &groupBy);
+
+struct GroupTotal {
+    std::string key;
+    std::size_t count = 0;
+    double revenue = 0.0;
+};
+
+// Booking count and price sum per group, ordered by key. Bookings without the grouping attribute
+// are left out. The rows are split into one range per thread, each aggregated into its own hash
+// table; the tables are merged at the end. A thread count of 0 uses
+// std::thread::hardware_concurrency(), 1 aggregates on the calling thread.
+std::vector<GroupTotal> groupBookings(const BookingStore &store, GroupBy groupBy, std::size_t threadCount = 0);
+
+#endif // BOOKINGGROUPS_H
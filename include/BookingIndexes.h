@@ -0,0 +1,93 @@
+#ifndef BOOKINGINDEXES_H
+#define BOOKINGINDEXES_H
+
+#include "BookingStore.h"
+#include "Date.h"
+#include "IntervalIndex.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Filter for TravelAgency::findBookings. Every set field must match; unset fields match all.
+// Attribute filters only match the booking kinds that have the attribute.
+struct BookingQuery {
+    std::optional<BookingKind> kind;
+    // Inclusive price bounds.
+    std::optional<double> minPrice;
+    std::optional<double> maxPrice;
+    std::optional<std::string> airline;
+    // Hotel city.
+    std::optional<std::string> city;
+    // Rental car company.
+    std::optional<std::string> company;
+    std::optional<std::string> fromAirport;
+    std::optional<std::string> toAirport;
+    std::optional<std::string> fromStation;
+    std::optional<std::string> toStation;
+};
+
+// Row number lists in ascending order, keyed by attribute value.
+using PostingMap = std::unordered_map<std::string_view, std::vector<std::uint32_t>>;
+
+// Secondary indexes over a BookingStore. Each index is built on first use and is safe to use from
+// several threads at once. The store may only grow, and only while no query runs; extend() then
+// brings the indexes built so far up to date.
+class BookingIndexes {
+public:
+    enum class Attribute { Airline, City, Company, FromAirport, ToAirport, FromStation, ToStation };
+
+    explicit BookingIndexes(const BookingStore &store) : store_(store), rowCount_(store.size()) {}
+
+    BookingIndexes(const BookingIndexes &) = delete;
+    BookingIndexes &operator=(const BookingIndexes &) = delete;
+
+    // Appends the rows overlapping [from, to] to `rows`, in no particular order.
+    void findOverlapping(DayNumber from, DayNumber to, std::vector<std::uint32_t> &rows) const;
+    const PostingMap &postings(Attribute attribute) const;
+
+    // Adds the rows appended to the store since construction or the previous call. Posting lists
+    // and the price index grow in place. Rows newer than the interval index are scanned by
+    // findOverlapping until they outgrow a fraction of the store; the index is rebuilt then.
+    void extend();
+
+    // Rows matching `query`, ascending. Posting lists of the equality filters are intersected
+    // smallest first; the price range joins as a list when it is more selective than those.
+    std::vector<std::uint32_t> find(const BookingQuery &query) const;
+
+private:
+    static constexpr std::size_t kAttributeCount = 7;
+
+    // Rows ordered by price, with the prices alongside for binary search.
+    struct PriceIndex {
+        std::vector<double> prices;
+        std::vector<std::uint32_t> rows;
+    };
+
+    const PriceIndex &priceIndex() const;
+    void buildPostings(Attribute attribute, std::size_t firstRow) const;
+
+    const BookingStore &store_;
+    // Rows covered by extend() so far.
+    std::size_t rowCount_;
+
+    // The *Ready flags are set by the builders and read by extend(), which runs exclusively.
+    mutable std::once_flag intervalsBuilt_;
+    mutable std::unique_ptr<IntervalIndex> intervals_;
+    // Rows the interval index covers; later rows are scanned.
+    mutable std::size_t intervalRows_ = 0;
+    mutable std::once_flag pricesBuilt_;
+    mutable bool pricesReady_ = false;
+    mutable PriceIndex prices_;
+    mutable std::array<std::once_flag, kAttributeCount> postingsBuilt_;
+    mutable std::array<bool, kAttributeCount> postingsReady_{};
+    mutable std::array<PostingMap, kAttributeCount> postings_;
+};
+
+#endif // BOOKINGINDEXES_H
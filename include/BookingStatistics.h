@@ -0,0 +1,80 @@
+#ifndef BOOKINGSTATISTICS_H
+#define BOOKINGSTATISTICS_H
+
+#include "Booking.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ReportWriter;
+
+// Approximate quantiles of a value distribution with a relative error of at most 1%. Values are
+// counted in logarithmically sized buckets, so memory depends on the spread of the values, not on
+// how many were added, and two sketches merge exactly by adding their bucket counts.
+class PriceSketch {
+public:
+    static constexpr double kRelativeAccuracy = 0.01;
+
+    void add(double value);
+    void merge(const PriceSketch &other);
+    void clear();
+
+    std::uint64_t count() const { return count_; }
+    // Value at quantile `q` in [0, 1]; 0 for an empty sketch.
+    double quantile(double q) const;
+
+private:
+    // Dense bucket counts for indices offset .. offset + counts.size() - 1.
+    struct Buckets {
+        int offset = 0;
+        std::vector<std::uint64_t> counts;
+
+        void add(int index, std::uint64_t count);
+    };
+
+    static int bucketIndex(double magnitude);
+    static double bucketValue(int index);
+
+    Buckets positive_;
+    Buckets negative_;
+    std::uint64_t zeroCount_ = 0;
+    std::uint64_t count_ = 0;
+};
+
+struct KindStatistics {
+    std::size_t count = 0;
+    double sum = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    PriceSketch prices;
+
+    double mean() const { return count == 0 ? 0.0 : sum / static_cast<double>(count); }
+    // Approximate price percentile, `q` in [0, 1]. The extremes are exact.
+    double quantile(double q) const;
+
+    void add(double price);
+    void merge(const KindStatistics &other);
+};
+
+// Price statistics per booking kind, updated as bookings are added so that queries never rescan
+// the bookings.
+class BookingStatistics {
+public:
+    void add(BookingKind kind, double price);
+    void merge(const BookingStatistics &other);
+    void clear();
+
+    const KindStatistics &forKind(BookingKind kind) const { return kinds_[static_cast<std::size_t>(kind)]; }
+    const KindStatistics &total() const { return total_; }
+
+private:
+    std::array<KindStatistics, 4> kinds_;
+    KindStatistics total_;
+};
+
+// "Flights: <count> (<sum> Euro), RentalCars: ..., Hotels: ..., Trains: ...", ending the line.
+void writeStatistics(const BookingStatistics &stats, ReportWriter &out);
+
+#endif // BOOKINGSTATISTICS_H
@@ -0,0 +1,108 @@
+#ifndef BOOKINGSTORE_H
+#define BOOKINGSTORE_H
+
+#include "Booking.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Side tables with the type-specific attributes of one booking kind. `rows` maps every entry back
+// to its row in the store.
+struct FlightColumns {
+    std::vector<std::uint32_t> rows;
+    std::vector<std::string_view> fromAirports;
+    std::vector<std::string_view> toAirports;
+    std::vector<std::string_view> airlines;
+};
+
+struct HotelColumns {
+    std::vector<std::uint32_t> rows;
+    std::vector<std::string_view> hotels;
+    std::vector<std::string_view> cities;
+};
+
+struct RentalCarColumns {
+    std::vector<std::uint32_t> rows;
+    std::vector<std::string_view> pickupLocations;
+    std::vector<std::string_view> returnLocations;
+    std::vector<std::string_view> companies;
+};
+
+struct TrainColumns {
+    std::vector<std::uint32_t> rows;
+    std::vector<std::string_view> fromStations;
+    std::vector<std::string_view> toStations;
+    std::vector<std::string_view> departureTimes;
+    std::vector<std::string_view> arrivalTimes;
+    // Via stations of entry i are viaStations[viaOffsets[i], viaOffsets[i + 1]).
+    std::vector<std::uint32_t> viaOffsets{0};
+    std::vector<std::string_view> viaStations;
+};
+
+// Columnar mirror of a booking collection. Attributes shared by all kinds live in contiguous
+// per-row columns; the remaining ones live in per-kind side tables. String columns are views into
+// the Booking objects they were appended from and stay valid for as long as those objects do.
+class BookingStore {
+public:
+    void append(const Booking &booking);
+    void reserve(std::size_t count);
+    void clear();
+
+    std::size_t size() const { return kinds_.size(); }
+
+    const std::vector<BookingKind> &kinds() const { return kinds_; }
+    const std::vector<double> &prices() const { return prices_; }
+    const std::vector<DayNumber> &fromDates() const { return fromDates_; }
+    const std::vector<DayNumber> &toDates() const { return toDates_; }
+    // Position of every row within the side table of its kind.
+    const std::vector<std::uint32_t> &sideRows() const { return sideRows_; }
+
+    const FlightColumns &flights() const { return flights_; }
+    const HotelColumns &hotels() const { return hotels_; }
+    const RentalCarColumns &rentalCars() const { return rentalCars_; }
+    const TrainColumns &trains() const { return trains_; }
+
+    const Booking &booking(std::size_t row) const { return *bookings_[row]; }
+
+    // Calls `visitor` with the booking at `row` as its concrete type, without RTTI.
+    template <class Visitor>
+    decltype(auto) visit(std::size_t row, Visitor &&visitor) const {
+        const Booking &booking = *bookings_[row];
+        switch (kinds_[row]) {
+        case BookingKind::Flight:
+            return std::forward<Visitor>(visitor)(static_cast<const FlightBooking &>(booking));
+        case BookingKind::Hotel:
+            return std::forward<Visitor>(visitor)(static_cast<const HotelReservation &>(booking));
+        case BookingKind::RentalCar:
+            return std::forward<Visitor>(visitor)(static_cast<const RentalCarReservation &>(booking));
+        case BookingKind::Train:
+            break;
+        }
+        return std::forward<Visitor>(visitor)(static_cast<const TrainTicket &>(booking));
+    }
+
+    template <class Visitor>
+    void forEach(Visitor &&visitor) const {
+        for (std::size_t row = 0; row < size(); ++row) {
+            visit(row, visitor);
+        }
+    }
+
+private:
+    std::vector<BookingKind> kinds_;
+    std::vector<double> prices_;
+    std::vector<DayNumber> fromDates_;
+    std::vector<DayNumber> toDates_;
+    std::vector<std::uint32_t> sideRows_;
+    std::vector<const Booking *> bookings_;
+
+    FlightColumns flights_;
+    HotelColumns hotels_;
+    RentalCarColumns rentalCars_;
+    TrainColumns trains_;
+};
+
+#endif // BOOKINGSTORE_H
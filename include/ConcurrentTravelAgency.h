@@ -0,0 +1,45 @@
+#ifndef CONCURRENTTRAVELAGENCY_H
+#define CONCURRENTTRAVELAGENCY_H
+
+#include "TravelAgency.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Shares loaded bookings between reader threads and a reloading writer. Every load builds a new
+// TravelAgency off to the side and publishes it in the second of two slots. Readers take the
+// current snapshot without any lock, with a counter increment and a shared_ptr copy, and use its
+// const member functions. A snapshot never changes once published and stays alive as long as a
+// reader holds it. A failed load throws and leaves the published snapshot as it was.
+class ConcurrentTravelAgency {
+public:
+    ConcurrentTravelAgency();
+
+    ConcurrentTravelAgency(const ConcurrentTravelAgency &) = delete;
+    ConcurrentTravelAgency &operator=(const ConcurrentTravelAgency &) = delete;
+
+    // The bookings as of the last successful load; never null.
+    std::shared_ptr<const TravelAgency> snapshot() const;
+
+    // Loads run one at a time; readers are never blocked by them.
+    void readFile(const std::string &path, const LoadOptions &options = {});
+    void readBinaryFile(const std::string &path, const LoadOptions &options = {});
+    // Publishes an empty agency.
+    void clear();
+
+private:
+    void publish(std::shared_ptr<const TravelAgency> agency);
+    static void waitForReaders(const std::atomic<std::size_t> &readers);
+
+    std::mutex loadMutex_;
+    // slots_[active_] is the current snapshot; the other slot is empty outside of publish.
+    // readers_[i] counts the readers that may be copying slots_[i].
+    std::shared_ptr<const TravelAgency> slots_[2];
+    std::atomic<unsigned> active_{0};
+    mutable std::atomic<std::size_t> readers_[2] = {};
+};
+
+#endif // CONCURRENTTRAVELAGENCY_H
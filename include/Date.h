@@ -0,0 +1,23 @@
+#ifndef DATE_H
+#define DATE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Calendar date as the number of days since 1970-01-01 (proleptic Gregorian calendar).
+using DayNumber = std::int32_t;
+
+DayNumber daysFromCivil(int year, unsigned month, unsigned day);
+void civilFromDays(DayNumber days, int &year, unsigned &month, unsigned &day);
+
+// Parses an eight-digit "YYYYMMDD" date and checks that it exists in the calendar.
+bool parseIsoDate(std::string_view text, DayNumber &days);
+// Writes the date as "YYYYMMDD" into `out[0..7]`.
+void writeIsoDate(DayNumber days, char *out);
+// Writes the date as "DD.MM.YYYY" into `out[0..9]`.
+void writeDisplayDate(DayNumber days, char *out);
+
+std::string formatDate(DayNumber days);
+
+#endif // DATE_H
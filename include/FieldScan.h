@@ -0,0 +1,85 @@
+#ifndef FIELDSCAN_H
+#define FIELDSCAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// SSE2 is part of every x86-64 CPU, so it needs no runtime check. Other targets use the scalar
+// loops below.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FIELDSCAN_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define FIELDSCAN_SSE2 0
+#endif
+
+#if FIELDSCAN_SSE2
+// Bit `i` is set if byte `i` of the 16 bytes at `data` is not a space.
+inline std::uint64_t nonSpaceMask16(const char *data) {
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+    const int spaces = _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')));
+    return static_cast<std::uint64_t>(~spaces & 0xFFFF);
+}
+
+inline unsigned lowestSetBit(std::uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward64(&index, value);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+}
+
+inline unsigned highestSetBit(std::uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanReverse64(&index, value);
+    return static_cast<unsigned>(index);
+#else
+    return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#endif
+}
+#endif
+
+// The `length` bytes at `slot` without their leading and trailing spaces, as trimSpaces. At least
+// `readable` bytes from `slot` on may be read; slots shorter than 16 bytes are classified with a
+// single 16-byte load when that many are readable, longer slots with overlapping loads inside the
+// slot.
+inline std::string_view trimPaddedSlot(const char *slot, std::size_t length, std::size_t readable) {
+#if FIELDSCAN_SSE2
+    if (length <= 64 && (length >= 16 || readable >= 16)) {
+        std::uint64_t filled = 0;
+        if (length < 16) {
+            filled = nonSpaceMask16(slot) & ((std::uint64_t{1} << length) - 1);
+        } else {
+            for (std::size_t offset = 0; offset < length; offset += 16) {
+                const std::size_t at = offset + 16 <= length ? offset : length - 16;
+                filled |= nonSpaceMask16(slot + at) << at;
+            }
+        }
+        if (filled == 0) {
+            return {};
+        }
+        const unsigned first = lowestSetBit(filled);
+        return {slot + first, highestSetBit(filled) - first + 1};
+    }
+#else
+    static_cast<void>(readable);
+#endif
+    std::size_t first = 0;
+    while (first < length && slot[first] == ' ') {
+        ++first;
+    }
+    std::size_t end = length;
+    while (end > first && slot[end - 1] == ' ') {
+        --end;
+    }
+    return {slot + first, end - first};
+}
+
+#endif // FIELDSCAN_H
@@ -0,0 +1,48 @@
+#ifndef INTERVALINDEX_H
+#define INTERVALINDEX_H
+
+#include "Date.h"
+
+#include <cstdint>
+#include <vector>
+
+// Static index over closed date intervals [from, to], one per booking row. Built once in
+// O(n log n); an overlap query reports the k matching rows in O(log n + k).
+//
+// A query [from, to] is answered as two disjoint parts: intervals starting inside the range
+// (binary search over the starts) and intervals starting before it that are still running on
+// `from` (stabbing query on a centered interval tree).
+class IntervalIndex {
+public:
+    // Intervals with to < from are indexed as [to, from].
+    IntervalIndex(const std::vector<DayNumber> &fromDates, const std::vector<DayNumber> &toDates);
+
+    // Appends the rows overlapping [from, to] to `rows`, in no particular order.
+    void findOverlapping(DayNumber from, DayNumber to, std::vector<std::uint32_t> &rows) const;
+
+private:
+    struct Interval {
+        DayNumber start;
+        DayNumber end;
+        std::uint32_t row;
+    };
+
+    // Intervals containing `center` are stored in byStart_ and byEnd_ at [begin, begin + count).
+    struct Node {
+        DayNumber center;
+        std::uint32_t begin;
+        std::uint32_t count;
+        std::int32_t left;
+        std::int32_t right;
+    };
+
+    std::int32_t build(std::vector<Interval> &intervals);
+
+    std::vector<Interval> sortedByStart_;
+    std::vector<Node> nodes_;
+    // Per node: ascending start, descending end.
+    std::vector<Interval> byStart_;
+    std::vector<Interval> byEnd_;
+};
+
+#endif // INTERVALINDEX_H
@@ -0,0 +1,47 @@
+#ifndef JSONBOOKINGREADER_H
+#define JSONBOOKINGREADER_H
+
+#include "Booking.h"
+#include "BookingArena.h"
+#include "StringPool.h"
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "json.hpp"
+
+// Byte range [start, end] of one bookings array element and the line on which it starts.
+struct ObjectRange {
+    std::size_t start;
+    std::size_t end;
+    std::size_t line;
+};
+
+// Receives one element of the bookings array together with the line on which it starts.
+using BookingElementHandler = std::function<void(const nlohmann::json &element, std::size_t lineNumber)>;
+
+// Streams a bookings document (either a top-level array or an object with a "bookings" array)
+// through nlohmann's SAX interface. Each array element is materialized on its own and handed to
+// `handler` as soon as it closes, so memory use does not grow with the size of the input.
+void readJsonBookingStream(std::istream &in, const std::string &path, const BookingElementHandler &handler);
+
+// Locates every element of the bookings array in a single pass over `content`. Returns false if the
+// document is not a plain array of objects (or an object holding one under "bookings"), or if its
+// structure around the elements is malformed; callers then fall back to readJsonBookingStream,
+// which produces the exact diagnostic.
+bool extractTopLevelArrayObjects(std::string_view content, std::vector<ObjectRange> &ranges);
+
+// Checks that `element` is an object with a non-empty string id and returns that id.
+const std::string &requireBookingId(const nlohmann::json &element, const std::string &path, std::size_t lineNumber);
+
+// Validates the remaining attributes of `element` and builds the matching booking in `arena`.
+// Repeated text attributes are interned in `strings`.
+BookingPtr makeBookingFromJson(const nlohmann::json &element, std::string_view id, const std::string &path,
+                               std::size_t lineNumber, BookingArena &arena, StringPool &strings);
+
+#endif // JSONBOOKINGREADER_H
@@ -0,0 +1,126 @@
+#ifndef LOADMETRICS_H
+#define LOADMETRICS_H
+
+#include "Booking.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Load instrumentation is compiled in unless the build defines TRAVELAGENCY_METRICS=0 (CMake
+// option TRAVELAGENCY_ENABLE_METRICS). Without it LoadRecorder is empty and every recording call is
+// an inline no-op.
+#ifndef TRAVELAGENCY_METRICS
+#define TRAVELAGENCY_METRICS 1
+#endif
+
+#if TRAVELAGENCY_METRICS
+#include "AllocationCounter.h"
+
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+#endif
+
+enum class LoadPhase : std::uint8_t {
+    // Opening, mapping or reading the input file.
+    Open,
+    // Locating the records: splitting the JSON array, sizing binary records, checking the header,
+    // string table and index of indexed files.
+    Scan,
+    // Turning JSON text into a document.
+    Parse,
+    // Validating attributes and constructing the bookings; one step, as every attribute is
+    // checked right where it is read.
+    Build,
+    // Looking up ids among the bookings loaded before (existsId).
+    DuplicateCheck,
+    // Adding bookings to the id index, the columns, the statistics and the station index.
+    Insert,
+    // Checking, reading and writing the snapshot cache.
+    Snapshot,
+};
+
+constexpr std::size_t kLoadPhaseCount = 7;
+
+// Lower camel case name as used in toJson().
+const char *loadPhaseName(LoadPhase phase);
+
+struct LoadMetrics {
+    bool enabled = TRAVELAGENCY_METRICS != 0;
+    double wallSeconds = 0.0;
+    // Per LoadPhase. Time spent on worker threads is summed over the threads, so on parallel loads
+    // the phases can add up to more than wallSeconds.
+    std::array<double, kLoadPhaseCount> phaseSeconds{};
+    std::uint64_t bytesRead = 0;
+    // Per BookingKind.
+    std::array<std::uint64_t, 4> records{};
+    // Global operator new calls while the load ran, from all threads of the process. Zero unless
+    // the program links AllocationHook.cpp (see AllocationCounter.h).
+    std::uint64_t allocations = 0;
+    std::uint64_t allocatedBytes = 0;
+
+    double seconds(LoadPhase phase) const { return phaseSeconds[static_cast<std::size_t>(phase)]; }
+    std::uint64_t recordCount(BookingKind kind) const { return records[static_cast<std::size_t>(kind)]; }
+    std::uint64_t totalRecords() const;
+    double recordsPerSecond() const;
+    double megabytesPerSecond() const;
+
+    // One JSON object on a single line.
+    std::string toJson() const;
+};
+
+// Collects the metrics of one load. Time is attributed to the phase entered last; phases switch
+// on every record, so a transition costs a single time stamp counter read where the CPU has one.
+// Worker threads record into their own recorder, which the loading thread merges afterwards.
+class LoadRecorder {
+public:
+#if TRAVELAGENCY_METRICS
+    LoadRecorder();
+
+    void enter(LoadPhase phase) { switchTo(static_cast<std::size_t>(phase)); }
+    void leave() { switchTo(kLoadPhaseCount); }
+    void addBytes(std::uint64_t bytes) { bytes_ += bytes; }
+    void merge(const LoadRecorder &worker);
+    // Stops recording and stores the results together with the record counts in `metrics`.
+    void finish(LoadMetrics &metrics, const std::array<std::uint64_t, 4> &records);
+
+private:
+    static std::uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    void switchTo(std::size_t phase) {
+        const std::uint64_t now = ticks();
+        if (current_ < kLoadPhaseCount) {
+            phaseTicks_[current_] += now - since_;
+        }
+        current_ = phase;
+        since_ = now;
+    }
+
+    std::array<std::uint64_t, kLoadPhaseCount> phaseTicks_{};
+    std::size_t current_ = kLoadPhaseCount;
+    std::uint64_t since_ = 0;
+    std::uint64_t bytes_ = 0;
+    std::chrono::steady_clock::time_point startTime_;
+    std::uint64_t startTicks_;
+    AllocationCounts startAllocations_;
+#else
+    void enter(LoadPhase) {}
+    void leave() {}
+    void addBytes(std::uint64_t) {}
+    void merge(const LoadRecorder &) {}
+    void finish(LoadMetrics &, const std::array<std::uint64_t, 4> &) {}
+#endif
+};
+
+#endif // LOADMETRICS_H
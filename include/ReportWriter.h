@@ -0,0 +1,57 @@
+#ifndef REPORTWRITER_H
+#define REPORTWRITER_H
+
+#include "Date.h"
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Formats report text into a reusable buffer and hands it to the sink in large blocks. The sink is
+// a std::ostream (std::cout, an std::ofstream, ...), a std::string that the text is appended to
+// or, on POSIX systems, a file descriptor written with write(2). Formatting never allocates once
+// the buffer exists.
+class ReportWriter {
+public:
+    static constexpr std::size_t kDefaultCapacity = 64 * 1024;
+
+    explicit ReportWriter(std::ostream &out, std::size_t capacity = kDefaultCapacity);
+    // The descriptor is not closed. Text already buffered in std::cout or stdio for the same
+    // descriptor must be flushed by the caller first.
+    explicit ReportWriter(int fd, std::size_t capacity = kDefaultCapacity);
+    explicit ReportWriter(std::string &out, std::size_t capacity = kDefaultCapacity);
+    // Flushes what is still buffered; write errors at this point are ignored.
+    ~ReportWriter();
+
+    ReportWriter(const ReportWriter &) = delete;
+    ReportWriter &operator=(const ReportWriter &) = delete;
+
+    ReportWriter &write(std::string_view text);
+    ReportWriter &write(char ch);
+    ReportWriter &writeInt(long long value);
+    // Fixed notation with two decimals, as `std::fixed << std::setprecision(2)`.
+    ReportWriter &writeFixed(double value);
+    // Shortest text that reads back as the same value, as `std::to_chars` without a format.
+    ReportWriter &writeDouble(double value);
+    // "DD.MM.YYYY", as formatDate.
+    ReportWriter &writeDate(DayNumber date);
+    // "YYYYMMDD", the form used by the input files.
+    ReportWriter &writeIsoDate(DayNumber date);
+
+    // Writes the buffered text to the sink. Throws std::runtime_error if the sink fails.
+    void flush();
+
+private:
+    char *reserve(std::size_t length);
+    void writeToSink(const char *data, std::size_t size);
+
+    std::vector<char> buffer_;
+    std::size_t used_ = 0;
+    std::ostream *stream_ = nullptr;
+    std::string *text_ = nullptr;
+    int fd_ = -1;
+};
+
+#endif // REPORTWRITER_H
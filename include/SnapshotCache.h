@@ -0,0 +1,40 @@
+#ifndef SNAPSHOTCACHE_H
+#define SNAPSHOTCACHE_H
+
+#include "BookingStore.h"
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Identifies the exact contents of a source file a snapshot was built from.
+struct SnapshotKey {
+    std::uint64_t size = 0;
+    std::int64_t modificationTime = 0;
+    std::uint64_t contentHash = 0;
+
+    bool operator==(const SnapshotKey &other) const {
+        return size == other.size && modificationTime == other.modificationTime &&
+               contentHash == other.contentHash;
+    }
+};
+
+// A snapshot is a small key header followed by the bookings in the indexed binary format. It is
+// stored next to the source as "<source>.snapshot".
+std::string snapshotPath(const std::string &sourcePath);
+
+// Reads size, modification time and content hash of `sourcePath`. Returns false if the file
+// cannot be read.
+bool computeSnapshotKey(const std::string &sourcePath, SnapshotKey &key);
+
+// Maps the snapshot at `path` into `image` if it was built from a source matching `key`.
+// `imageOffset` receives the start of the indexed binary data. Returns false for a missing,
+// foreign, stale or damaged snapshot.
+bool openSnapshot(const std::string &path, const SnapshotKey &key, MappedFile &image, std::size_t &imageOffset);
+
+// Writes a snapshot of `store` for a source matching `key`. The file is replaced atomically;
+// throws std::runtime_error on failure.
+void writeSnapshot(const std::string &path, const SnapshotKey &key, const BookingStore &store);
+
+#endif // SNAPSHOTCACHE_H
@@ -0,0 +1,51 @@
+#ifndef STATIONINDEX_H
+#define STATIONINDEX_H
+
+#include "Booking.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Inverted index from station to the train tickets whose route touches it. A route is the
+// departure station, the via stations in order, then the arrival station. Station names are
+// interned to dense ids; the names are views of the tickets' text and live as long as they do.
+//
+// Tickets must be added in ascending row order, which keeps every posting list sorted and lets
+// loaders extend the index as they go.
+class StationIndex {
+public:
+    using StationId = std::uint32_t;
+    static constexpr StationId kNoStation = UINT32_MAX;
+
+    void add(const TrainTicket &ticket, std::uint32_t row);
+    void clear();
+
+    std::size_t stationCount() const { return names_.size(); }
+    StationId find(std::string_view station) const;
+    std::string_view name(StationId id) const { return names_[id]; }
+
+    // Rows of the tickets whose route contains `station`, ascending.
+    void passingThrough(std::string_view station, std::vector<std::uint32_t> &rows) const;
+    // Rows of the tickets that reach `to` after `from` somewhere along their route, ascending.
+    void connecting(std::string_view from, std::string_view to, std::vector<std::uint32_t> &rows) const;
+
+private:
+    // First and last position of the station on the route of ticket `row`.
+    struct Posting {
+        std::uint32_t row;
+        std::uint16_t first;
+        std::uint16_t last;
+    };
+
+    StationId intern(std::string_view station);
+    void addStop(std::string_view station, std::uint32_t row, std::uint16_t position);
+
+    std::unordered_map<std::string_view, StationId> ids_;
+    std::vector<std::string_view> names_;
+    std::vector<std::vector<Posting>> postings_;
+};
+
+#endif // STATIONINDEX_H
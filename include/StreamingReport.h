@@ -0,0 +1,35 @@
+#ifndef STREAMINGREPORT_H
+#define STREAMINGREPORT_H
+
+#include "BookingStatistics.h"
+#include "ReportWriter.h"
+
+#include <cstddef>
+#include <string>
+
+struct StreamingReportOptions {
+    // Write the details of every booking, as printAllDetails.
+    bool details = true;
+    // Finish with the totals per booking kind, as printStatistics.
+    bool statistics = true;
+    // Reject repeated ids like readBinaryFile. The file is checked in full before anything is
+    // reported, so a repeated id or a malformed record fails without output, as in readBinaryFile.
+    // The ids go through a Bloom filter of at most `idFilterBytes`; only ids the filter has seen
+    // before are kept, and if there are any the file is read once more to confirm them.
+    bool checkDuplicateIds = false;
+    std::size_t idFilterBytes = 64 * 1024 * 1024;
+    // Fixed-width files are read in blocks of this size; one block is read on a background
+    // thread while the previous one is decoded and formatted.
+    std::size_t blockSize = 4 * 1024 * 1024;
+};
+
+// Writes the same report as readBinaryFile followed by printAllDetails and printStatistics, but
+// decodes, formats and discards one record at a time, so memory does not grow with the file.
+// Accepts both binary formats; indexed files are memory-mapped. Errors are thrown with the
+// messages of readBinaryFile. Without checkDuplicateIds repeated ids are not detected, and a
+// malformed record fails after the report of the records before it has been written. Returns the
+// totals per booking kind.
+BookingStatistics streamBinaryReport(const std::string &path, ReportWriter &out,
+                                     const StreamingReportOptions &options = {});
+
+#endif // STREAMINGREPORT_H
@@ -0,0 +1,60 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+struct StringPoolStats {
+    std::size_t uniqueStrings = 0;
+    // Characters stored in the pool.
+    std::size_t storedBytes = 0;
+    std::size_t internedStrings = 0;
+    // Characters passed to intern().
+    std::size_t requestedBytes = 0;
+
+    // Memory saved compared to one std::string per attribute: the duplicate characters plus the
+    // size difference between a std::string and a std::string_view member.
+    std::size_t savedBytes() const {
+        return requestedBytes - storedBytes + internedStrings * (sizeof(std::string) - sizeof(std::string_view));
+    }
+};
+
+// Deduplicating storage for attribute strings that repeat across bookings. Interned views stay
+// valid until clear() or destruction; equal strings share one copy, so their views compare equal
+// by data pointer. intern() may be called from several threads at once.
+class StringPool {
+public:
+    StringPool() = default;
+
+    StringPool(const StringPool &) = delete;
+    StringPool &operator=(const StringPool &) = delete;
+
+    std::string_view intern(std::string_view value);
+    void clear();
+    StringPoolStats stats() const;
+
+private:
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_set<std::string_view> entries;
+        std::vector<std::unique_ptr<char[]>> blocks;
+        char *cursor = nullptr;
+        std::size_t available = 0;
+        std::size_t storedBytes = 0;
+        std::size_t internedStrings = 0;
+        std::size_t requestedBytes = 0;
+
+        std::string_view store(std::string_view value);
+    };
+
+    static constexpr std::size_t kShardCount = 16;
+    std::array<Shard, kShardCount> shards_;
+};
+
+#endif // STRINGPOOL_H
@@ -1,29 +1,164 @@
 #ifndef TRAVELAGENCY_H
 #define TRAVELAGENCY_H
 
+#include "BinaryBookingWriter.h"
 #include "Booking.h"
+#include "BookingExport.h"
+#include "BookingArena.h"
+#include "BookingGroups.h"
+#include "BookingIndexes.h"
+#include "BookingStatistics.h"
+#include "BookingStore.h"
+#include "LoadMetrics.h"
+#include "ReportWriter.h"
+#include "StationIndex.h"
+#include "StringPool.h"
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+class BinaryCursor;
+class IndexedBinaryFile;
+class MappedFile;
+class ThreadPool;
+struct BinaryChunk;
+struct SnapshotKey;
+
+struct LoadOptions {
+    // Decode on a thread pool. The loaded bookings and any reported error are the same as for a
+    // sequential load.
+    bool parallel = false;
+    // Worker threads for parallel loads; 0 uses std::thread::hardware_concurrency().
+    std::size_t threadCount = 0;
+    // readFile only: reuse "<path>.snapshot" if it was built from the current contents of the
+    // file, and write it after a full parse otherwise.
+    bool useSnapshot = false;
+};
+
+// Const member functions may run concurrently with each other; everything else needs exclusive
+// access. ConcurrentTravelAgency publishes agencies to readers while reloads run.
 class TravelAgency {
 public:
-    TravelAgency() = default;
+    TravelAgency();
     ~TravelAgency();
 
-    void readFile(const std::string &path);
-    void readBinaryFile(const std::string &path);
+    void readFile(const std::string &path, const LoadOptions &options = {});
+    // Reads the fixed-width format as well as the indexed format written by writeBinaryFile.
+    void readBinaryFile(const std::string &path, const LoadOptions &options = {});
+    // Adds the fixed-width records appended to `path` since it was last read by readBinaryFile or
+    // appendBinaryFile; any other file is read from its start. A record that is still being
+    // written at the end of the file is left for the next call. Duplicate ids are rejected
+    // against all loaded bookings; on any error nothing is added. Returns the number of bookings
+    // added.
+    std::size_t appendBinaryFile(const std::string &path);
+    // Moves all bookings of `other` behind the loaded ones, keeping their order, and leaves
+    // `other` empty. Throws if an id of `other` is already loaded; nothing is moved then. The
+    // load metrics and the file followed by appendBinaryFile stay those of this agency.
+    void merge(TravelAgency &other);
+    void writeBinaryFile(const std::string &path, BinaryFormat format = BinaryFormat::Indexed) const;
+    // Export all bookings in load order. The JSON file reads back through readFile; a booking with
+    // an empty or non-UTF-8 attribute, which only binary files can hold, fails the JSON export
+    // before the file is opened.
+    void writeJsonFile(const std::string &path, const ExportOptions &options = {}) const;
+    void writeCsvFile(const std::string &path, const ExportOptions &options = {}) const;
+    // Both reports go to std::cout unless another ReportWriter is given.
     void printAllDetails() const;
+    void printAllDetails(ReportWriter &out) const;
     void printStatistics() const;
+    void printStatistics(ReportWriter &out) const;
+    // One line per group: "<key>: <count> (<revenue> Euro)".
+    void printGroupReport(GroupBy groupBy) const;
+    void printGroupReport(GroupBy groupBy, ReportWriter &out) const;
     void clear();
-    bool existsId(const std::string &id) const;
+    bool existsId(std::string_view id) const;
+    const Booking *findById(std::string_view id) const;
+
+    // Bookings whose [fromDate, toDate] overlaps [from, to], both ends inclusive, in no particular
+    // order. The interval index behind it is built on the first query after a load.
+    std::vector<const Booking *> findOverlapping(DayNumber from, DayNumber to) const;
+    // Bookings matching every filter set in `query`, in load order. The secondary indexes are
+    // built as the filters first need them, extended by appendBinaryFile and dropped on reloads.
+    std::vector<const Booking *> findBookings(const BookingQuery &query) const;
+    // Train tickets stopping at `station` as departure, via or arrival station, in load order.
+    std::vector<const TrainTicket *> findTrainsThrough(std::string_view station) const;
+    // Train tickets stopping at `from` and at a later stop at `to`, in load order.
+    std::vector<const TrainTicket *> findTrainConnections(std::string_view from, std::string_view to) const;
+
+    std::size_t size() const { return bookings_.size(); }
+    const BookingStore &store() const { return store_; }
+    // Phase timings, byte, record and allocation counts of the load that produced the current
+    // bookings, or of the last appendBinaryFile. Failed loads leave them unchanged. All zero when
+    // built without TRAVELAGENCY_METRICS.
+    const LoadMetrics &loadMetrics() const { return loadMetrics_; }
+    // Price statistics per booking kind, kept up to date while loading.
+    const BookingStatistics &statistics() const { return stats_; }
+    // Booking count and revenue per group, ordered by key; see groupBookings.
+    std::vector<GroupTotal> groupTotals(GroupBy groupBy, std::size_t threadCount = 0) const {
+        return groupBookings(store_, groupBy, threadCount);
+    }
+    // Station to train ticket index, kept up to date while loading.
+    const StationIndex &stations() const { return stations_; }
+    // How much the shared attribute string pool currently deduplicates.
+    StringPoolStats stringPoolStats() const { return strings_->stats(); }
+
+    // Calls `visitor` for every booking in load order, passing it as its concrete type.
+    template <class Visitor>
+    void visitBookings(Visitor &&visitor) const {
+        store_.forEach(std::forward<Visitor>(visitor));
+    }
 
 private:
-    std::vector<std::unique_ptr<Booking>> bookings_;
+    // Backing memory of the bookings and their ids. The first arena serves sequential loads;
+    // parallel loads add one per worker. clear() hands everything back at once.
+    std::vector<std::unique_ptr<BookingArena>> arenas_;
+    // Snapshot images whose string tables the bookings view directly.
+    std::vector<std::unique_ptr<MappedFile>> images_;
+    std::vector<BookingPtr> bookings_;
+    // Keys are views of the ids held by the bookings.
+    std::unordered_map<std::string_view, std::size_t> idIndex_;
+    BookingStore store_;
+    BookingStatistics stats_;
+    StationIndex stations_;
+    // Built on first use under the mutex; readers that find `builtIndexes_` set skip the lock.
+    mutable std::mutex indexesMutex_;
+    mutable std::unique_ptr<BookingIndexes> indexes_;
+    mutable std::atomic<const BookingIndexes *> builtIndexes_{nullptr};
+    // Fixed-width binary file the bookings were last read from, and how many of its bytes.
+    std::string tailPath_;
+    std::uint64_t tailOffset_ = 0;
+    LoadMetrics loadMetrics_;
+    // Interned attribute strings shared by both loaders; bookings hold views into it.
+    std::unique_ptr<StringPool> strings_ = std::make_unique<StringPool>();
+    // String pools of merged agencies, kept for the views their bookings hold.
+    std::vector<std::unique_ptr<StringPool>> mergedStrings_;
 
-    void addBooking(std::unique_ptr<Booking> booking);
+    BookingArena &arena() { return *arenas_.front(); }
+    const BookingIndexes &indexes() const;
+    void dropIndexes();
+    void adoptArena(std::unique_ptr<BookingArena> arena);
+    void addBooking(BookingPtr booking);
+    void reserve(std::size_t additional);
+    void readBinaryRecords(BinaryCursor &in, LoadRecorder &recorder);
+    void readBinaryRecordsParallel(BinaryCursor &in, const LoadOptions &options, LoadRecorder &recorder);
+    void readJsonFile(const std::string &path, const LoadOptions &options, LoadRecorder &recorder);
+    bool readSnapshot(const std::string &path, const SnapshotKey &key, const LoadOptions &options,
+                      LoadRecorder &recorder);
+    // With `copyText` unset the bookings keep views into `file`, which must outlive them.
+    void readIndexedBinaryRecords(const IndexedBinaryFile &file, const LoadOptions &options, bool copyText,
+                                  LoadRecorder &recorder);
+    void decodeBinaryChunks(std::vector<BinaryChunk> &chunks, const IndexedBinaryFile *indexed, StringPool *strings,
+                            ThreadPool &pool, LoadRecorder &recorder);
+    bool readJsonObjectsParallel(std::string_view content, const std::string &path, const LoadOptions &options,
+                                 LoadRecorder &recorder);
+    void swap(TravelAgency &other) noexcept;
 };
 
 #endif // TRAVELAGENCY_H
@@ -0,0 +1,78 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+// Counters of one thread. They are allocated with malloc, never freed and handed to the next new
+// thread once their thread has exited, so the sum over all of them stays the process total.
+struct alignas(64) ThreadCounts {
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> bytes{0};
+    std::atomic<bool> inUse{true};
+    ThreadCounts *next = nullptr;
+};
+
+std::atomic<ThreadCounts *> registry{nullptr};
+
+// Reuses the counters of an exited thread or adds new ones. Uses malloc, not operator new, as it
+// runs inside the replaced allocation functions.
+ThreadCounts *acquireCounts() {
+    for (ThreadCounts *counts = registry.load(std::memory_order_acquire); counts != nullptr; counts = counts->next) {
+        bool expected = false;
+        if (counts->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return counts;
+        }
+    }
+    void *memory = std::aligned_alloc(alignof(ThreadCounts), sizeof(ThreadCounts));
+    if (memory == nullptr) {
+        return nullptr;
+    }
+    auto *counts = new (memory) ThreadCounts;
+    counts->next = registry.load(std::memory_order_relaxed);
+    while (!registry.compare_exchange_weak(counts->next, counts, std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+    }
+    return counts;
+}
+
+// Hands the counters of an exiting thread back for reuse.
+struct CountsRelease {
+    ThreadCounts *counts = nullptr;
+
+    ~CountsRelease() {
+        if (counts != nullptr) {
+            counts->inUse.store(false, std::memory_order_release);
+        }
+    }
+};
+
+thread_local ThreadCounts *threadCounts = nullptr;
+thread_local CountsRelease threadRelease;
+} // namespace
+
+void countAllocation(std::size_t bytes) {
+    ThreadCounts *counts = threadCounts;
+    if (counts == nullptr) {
+        counts = acquireCounts();
+        if (counts == nullptr) {
+            return;
+        }
+        threadCounts = counts;
+        threadRelease.counts = counts;
+    }
+    // Only this thread adds to its counters (or, after it exited, the one thread reusing them),
+    // so the additions never contend.
+    counts->allocations.fetch_add(1, std::memory_order_relaxed);
+    counts->bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+AllocationCounts allocationCounts() {
+    AllocationCounts total;
+    for (ThreadCounts *counts = registry.load(std::memory_order_acquire); counts != nullptr; counts = counts->next) {
+        total.allocations += counts->allocations.load(std::memory_order_relaxed);
+        total.bytes += counts->bytes.load(std::memory_order_relaxed);
+    }
+    return total;
+}
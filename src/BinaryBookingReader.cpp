@@ -0,0 +1,322 @@
+#include "BinaryBookingReader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+DayNumber parseBinaryDate(std::string_view text) {
+    DayNumber date = 0;
+    if (!parseIsoDate(text, date)) {
+        throw std::runtime_error("Binary record contains invalid date.");
+    }
+    return date;
+}
+
+std::string_view requireAirportCode(std::string_view code) {
+    if (!isAirportCode(code)) {
+        throw std::runtime_error("Binary record contains invalid airport code.");
+    }
+    return code;
+}
+
+std::string_view requireClockTime(std::string_view time) {
+    if (!isClockTime(time)) {
+        throw std::runtime_error("Binary record contains invalid time.");
+    }
+    return time;
+}
+} // namespace
+
+std::size_t binaryRecordSize(const char *data, std::size_t available) {
+    if (available < kBinaryCommonLength) {
+        return 0;
+    }
+
+    std::size_t size = kBinaryCommonLength;
+    switch (data[0]) {
+    case 'F':
+        size += 2 * kBinaryAirportLength + kBinaryTextLength;
+        break;
+    case 'H':
+        size += 2 * kBinaryTextLength;
+        break;
+    case 'R':
+        size += 3 * kBinaryTextLength;
+        break;
+    case 'T': {
+        size += 2 * kBinaryTextLength + 2 * kBinaryTimeLength;
+        if (available < size + sizeof(std::int32_t)) {
+            return 0;
+        }
+        std::int32_t countVia = 0;
+        std::memcpy(&countVia, data + size, sizeof(std::int32_t));
+        if (countVia < 0) {
+            return 0;
+        }
+        size += sizeof(std::int32_t) + static_cast<std::size_t>(countVia) * kBinaryTextLength;
+        break;
+    }
+    default:
+        return 0;
+    }
+
+    return size <= available ? size : 0;
+}
+
+bool isIncompleteBinaryRecord(const char *data, std::size_t available) {
+    if (available == 0) {
+        return false;
+    }
+    switch (data[0]) {
+    case 'F':
+    case 'H':
+    case 'R':
+        break;
+    case 'T': {
+        const std::size_t countOffset = kBinaryCommonLength + 2 * kBinaryTextLength + 2 * kBinaryTimeLength;
+        if (available >= countOffset + sizeof(std::int32_t)) {
+            std::int32_t countVia = 0;
+            std::memcpy(&countVia, data + countOffset, sizeof(std::int32_t));
+            if (countVia < 0) {
+                return false;
+            }
+        }
+        break;
+    }
+    default:
+        return false;
+    }
+    return binaryRecordSize(data, available) == 0;
+}
+
+BookingPtr readBinaryRecord(BinaryCursor &in, const std::function<void(std::string_view)> &checkId,
+                            BookingArena &arena, StringPool &strings) {
+    char type = in.readChar();
+
+    std::string_view id = in.readFixedString(kBinaryIdLength);
+    if (id.empty()) {
+        throw std::runtime_error("Binary record contains empty id.");
+    }
+    checkId(id);
+
+    double price = in.readDouble();
+    if (!std::isfinite(price)) {
+        throw std::runtime_error("Binary record contains invalid price value.");
+    }
+
+    DayNumber fromDate = parseBinaryDate(in.readFixedString(kBinaryDateLength));
+    DayNumber toDate = parseBinaryDate(in.readFixedString(kBinaryDateLength));
+
+    switch (type) {
+    case 'F': {
+        std::string_view fromAirport = requireAirportCode(in.readFixedString(kBinaryAirportLength));
+        std::string_view toAirport = requireAirportCode(in.readFixedString(kBinaryAirportLength));
+        std::string_view airline = in.readFixedString(kBinaryTextLength);
+        return arena.create<FlightBooking>(arena.copy(id), price, fromDate, toDate,
+                                           strings.intern(fromAirport), strings.intern(toAirport),
+                                           strings.intern(airline));
+    }
+    case 'H': {
+        std::string_view hotel = in.readFixedString(kBinaryTextLength);
+        std::string_view city = in.readFixedString(kBinaryTextLength);
+        return arena.create<HotelReservation>(arena.copy(id), price, fromDate, toDate,
+                                              strings.intern(hotel), strings.intern(city));
+    }
+    case 'R': {
+        std::string_view pickup = in.readFixedString(kBinaryTextLength);
+        std::string_view dropoff = in.readFixedString(kBinaryTextLength);
+        std::string_view company = in.readFixedString(kBinaryTextLength);
+        return arena.create<RentalCarReservation>(arena.copy(id), price, fromDate, toDate,
+                                                  strings.intern(pickup), strings.intern(dropoff),
+                                                  strings.intern(company));
+    }
+    case 'T': {
+        std::string_view fromStation = in.readFixedString(kBinaryTextLength);
+        std::string_view toStation = in.readFixedString(kBinaryTextLength);
+        std::string_view departure = requireClockTime(in.readFixedString(kBinaryTimeLength));
+        std::string_view arrival = requireClockTime(in.readFixedString(kBinaryTimeLength));
+        std::int32_t countVia = in.readInt32();
+        if (countVia < 0) {
+            throw std::runtime_error("Binary record contains negative via station count.");
+        }
+        std::pmr::vector<std::string_view> viaStations(arena.resource());
+        viaStations.reserve(std::min(static_cast<std::size_t>(countVia), in.remaining() / kBinaryTextLength));
+        for (std::int32_t i = 0; i < countVia; ++i) {
+            viaStations.push_back(strings.intern(in.readFixedString(kBinaryTextLength)));
+        }
+        return arena.create<TrainTicket>(arena.copy(id), price, fromDate, toDate,
+                                         strings.intern(fromStation), strings.intern(toStation),
+                                         strings.intern(departure), strings.intern(arrival), std::move(viaStations));
+    }
+    default:
+        throw std::runtime_error("Unknown record type in binary file: " + std::string(1, type));
+    }
+}
+
+namespace {
+[[noreturn]] void invalidIndexedFile(const char *what) {
+    throw std::runtime_error(std::string("Invalid ") + what + " in binary file.");
+}
+
+std::uint64_t loadUInt64(const char *data) {
+    std::uint64_t value = 0;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+std::string_view readStringRef(BinaryCursor &in, const IndexedBinaryFile &file) {
+    std::uint32_t ref = in.readUInt32();
+    if (ref >= file.strings().size()) {
+        throw std::runtime_error("Binary record references an unknown string.");
+    }
+    return file.strings()[ref];
+}
+} // namespace
+
+bool isIndexedBinaryFile(const char *data, std::size_t size) {
+    return size >= sizeof(kIndexedBinaryMagic) &&
+           std::memcmp(data, kIndexedBinaryMagic, sizeof(kIndexedBinaryMagic)) == 0;
+}
+
+IndexedBinaryFile::IndexedBinaryFile(const char *data, std::size_t size) : data_(data) {
+    BinaryCursor header(data, data + size);
+    if (size < kIndexedBinaryHeaderLength || !isIndexedBinaryFile(data, size)) {
+        invalidIndexedFile("header");
+    }
+    header.skip(sizeof(kIndexedBinaryMagic));
+    std::uint32_t version = header.readUInt32();
+    if (version != kIndexedBinaryVersion) {
+        throw std::runtime_error("Unsupported binary file version: " + std::to_string(version));
+    }
+    std::uint64_t recordCount = header.readUInt64();
+    std::uint64_t stringTableOffset = header.readUInt64();
+    std::uint64_t indexOffset = header.readUInt64();
+    if (stringTableOffset < kIndexedBinaryHeaderLength || indexOffset < stringTableOffset || indexOffset > size ||
+        recordCount > (size - indexOffset) / sizeof(std::uint64_t) ||
+        indexOffset + recordCount * sizeof(std::uint64_t) != size) {
+        invalidIndexedFile("header");
+    }
+    recordCount_ = static_cast<std::size_t>(recordCount);
+    stringTableOffset_ = static_cast<std::size_t>(stringTableOffset);
+    index_ = data + indexOffset;
+
+    BinaryCursor table(data + stringTableOffset_, data + indexOffset);
+    if (table.remaining() < sizeof(std::uint32_t)) {
+        invalidIndexedFile("string table");
+    }
+    std::uint32_t stringCount = table.readUInt32();
+    if (stringCount > table.remaining() / (2 * sizeof(std::uint32_t))) {
+        invalidIndexedFile("string table");
+    }
+    const char *bytes = table.position() + std::size_t{stringCount} * 2 * sizeof(std::uint32_t);
+    const std::size_t byteCount = table.remaining() - std::size_t{stringCount} * 2 * sizeof(std::uint32_t);
+    strings_.reserve(stringCount);
+    for (std::uint32_t i = 0; i < stringCount; ++i) {
+        std::uint32_t offset = table.readUInt32();
+        std::uint32_t length = table.readUInt32();
+        if (offset > byteCount || length > byteCount - offset) {
+            invalidIndexedFile("string table");
+        }
+        strings_.emplace_back(bytes + offset, length);
+    }
+
+    // Records are stored back to back in index order; checking this once lets record() trust
+    // the index.
+    std::size_t expected = kIndexedBinaryHeaderLength;
+    for (std::size_t i = 0; i < recordCount_; ++i) {
+        std::size_t offset = recordOffset(i);
+        if (i == 0 ? offset != expected : offset <= expected || offset >= stringTableOffset_) {
+            invalidIndexedFile("record index");
+        }
+        expected = offset;
+    }
+    if (recordCount_ == 0 && stringTableOffset_ != kIndexedBinaryHeaderLength) {
+        invalidIndexedFile("record index");
+    }
+}
+
+std::size_t IndexedBinaryFile::recordOffset(std::size_t index) const {
+    return static_cast<std::size_t>(loadUInt64(index_ + index * sizeof(std::uint64_t)));
+}
+
+BinaryCursor IndexedBinaryFile::record(std::size_t index) const {
+    std::size_t end = index + 1 < recordCount_ ? recordOffset(index + 1) : stringTableOffset_;
+    return BinaryCursor(data_ + recordOffset(index), data_ + end);
+}
+
+BookingPtr readIndexedBinaryRecord(const IndexedBinaryFile &file, std::size_t index,
+                                   const std::function<void(std::string_view)> &checkId, BookingArena &arena,
+                                   StringPool *strings) {
+    // Without a pool the booking keeps views into the string table, which is already deduplicated.
+    auto text = [&](std::string_view value) { return strings != nullptr ? strings->intern(value) : value; };
+    auto own = [&](std::string_view value) { return strings != nullptr ? arena.copy(value) : value; };
+
+    BinaryCursor in = file.record(index);
+    char type = in.readChar();
+
+    std::string_view id = readStringRef(in, file);
+    if (id.empty()) {
+        throw std::runtime_error("Binary record contains empty id.");
+    }
+    checkId(id);
+
+    double price = in.readDouble();
+    if (!std::isfinite(price)) {
+        throw std::runtime_error("Binary record contains invalid price value.");
+    }
+
+    DayNumber fromDate = parseBinaryDate(readStringRef(in, file));
+    DayNumber toDate = parseBinaryDate(readStringRef(in, file));
+
+    BookingPtr booking;
+    switch (type) {
+    case 'F': {
+        std::string_view fromAirport = requireAirportCode(readStringRef(in, file));
+        std::string_view toAirport = requireAirportCode(readStringRef(in, file));
+        std::string_view airline = readStringRef(in, file);
+        booking = arena.create<FlightBooking>(own(id), price, fromDate, toDate, text(fromAirport), text(toAirport),
+                                              text(airline));
+        break;
+    }
+    case 'H': {
+        std::string_view hotel = readStringRef(in, file);
+        std::string_view city = readStringRef(in, file);
+        booking = arena.create<HotelReservation>(own(id), price, fromDate, toDate, text(hotel), text(city));
+        break;
+    }
+    case 'R': {
+        std::string_view pickup = readStringRef(in, file);
+        std::string_view dropoff = readStringRef(in, file);
+        std::string_view company = readStringRef(in, file);
+        booking = arena.create<RentalCarReservation>(own(id), price, fromDate, toDate, text(pickup), text(dropoff),
+                                                     text(company));
+        break;
+    }
+    case 'T': {
+        std::string_view fromStation = readStringRef(in, file);
+        std::string_view toStation = readStringRef(in, file);
+        std::string_view departure = requireClockTime(readStringRef(in, file));
+        std::string_view arrival = requireClockTime(readStringRef(in, file));
+        std::uint32_t countVia = in.readUInt32();
+        std::pmr::vector<std::string_view> viaStations(arena.resource());
+        viaStations.reserve(std::min<std::size_t>(countVia, in.remaining() / sizeof(std::uint32_t)));
+        for (std::uint32_t i = 0; i < countVia; ++i) {
+            viaStations.push_back(text(readStringRef(in, file)));
+        }
+        booking = arena.create<TrainTicket>(own(id), price, fromDate, toDate, text(fromStation), text(toStation),
+                                            text(departure), text(arrival), std::move(viaStations));
+        break;
+    }
+    default:
+        throw std::runtime_error("Unknown record type in binary file: " + std::string(1, type));
+    }
+
+    if (!in.atEnd()) {
+        throw std::runtime_error("Binary record does not match its index entry.");
+    }
+    return booking;
+}
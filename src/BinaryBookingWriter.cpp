@@ -0,0 +1,282 @@
+#include "BinaryBookingWriter.h"
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "BinaryBookingReader.h"
+#include "ReportWriter.h"
+
+namespace {
+template <class T>
+void writeRaw(ReportWriter &out, const T &value) {
+    out.write(std::string_view(reinterpret_cast<const char *>(&value), sizeof(T)));
+}
+
+// Writes the fixed-width layout read by readBinaryRecord.
+class FixedWidthWriter {
+public:
+    explicit FixedWidthWriter(ReportWriter &out) : out_(out) {}
+
+    void operator()(const FlightBooking &booking) {
+        common('F', booking);
+        slot(booking, booking.getFromAirport(), kBinaryAirportLength);
+        slot(booking, booking.getToAirport(), kBinaryAirportLength);
+        slot(booking, booking.getAirline(), kBinaryTextLength);
+    }
+
+    void operator()(const HotelReservation &booking) {
+        common('H', booking);
+        slot(booking, booking.getHotel(), kBinaryTextLength);
+        slot(booking, booking.getCity(), kBinaryTextLength);
+    }
+
+    void operator()(const RentalCarReservation &booking) {
+        common('R', booking);
+        slot(booking, booking.getPickupLocation(), kBinaryTextLength);
+        slot(booking, booking.getReturnLocation(), kBinaryTextLength);
+        slot(booking, booking.getCompany(), kBinaryTextLength);
+    }
+
+    void operator()(const TrainTicket &booking) {
+        common('T', booking);
+        slot(booking, booking.getFromStation(), kBinaryTextLength);
+        slot(booking, booking.getToStation(), kBinaryTextLength);
+        slot(booking, booking.getDepartureTime(), kBinaryTimeLength);
+        slot(booking, booking.getArrivalTime(), kBinaryTimeLength);
+        const auto &via = booking.getViaStations();
+        if (via.size() > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max())) {
+            throw std::runtime_error("Booking '" + std::string(booking.getId()) + "' has too many via stations.");
+        }
+        writeRaw(out_, static_cast<std::int32_t>(via.size()));
+        for (std::string_view station : via) {
+            slot(booking, station, kBinaryTextLength);
+        }
+    }
+
+private:
+    void common(char type, const Booking &booking) {
+        out_.write(type);
+        slot(booking, booking.getId(), kBinaryIdLength);
+        writeRaw(out_, booking.getPrice());
+        date(booking.getFromDate());
+        date(booking.getToDate());
+    }
+
+    void date(DayNumber value) {
+        char text[kBinaryDateLength];
+        writeIsoDate(value, text);
+        out_.write(std::string_view(text, sizeof(text)));
+    }
+
+    void slot(const Booking &booking, std::string_view value, std::size_t width) {
+        if (value.size() > width) {
+            throw std::runtime_error("Booking '" + std::string(booking.getId()) + "': '" + std::string(value) +
+                                     "' does not fit the fixed-width binary format.");
+        }
+        out_.write(value);
+        for (std::size_t i = value.size(); i < width; ++i) {
+            out_.write(' ');
+        }
+    }
+
+    ReportWriter &out_;
+};
+
+// Assigns string table references. Every distinct string is stored once.
+class StringTable {
+public:
+    std::uint32_t add(std::string_view value) {
+        auto [it, inserted] = refs_.try_emplace(value, static_cast<std::uint32_t>(strings_.size()));
+        if (inserted) {
+            if (strings_.size() == std::numeric_limits<std::uint32_t>::max() ||
+                bytes_ + value.size() > std::numeric_limits<std::uint32_t>::max()) {
+                throw std::runtime_error("Too many strings for the indexed binary format.");
+            }
+            strings_.push_back(value);
+            bytes_ += value.size();
+        }
+        return it->second;
+    }
+
+    std::uint32_t addDate(DayNumber date) {
+        auto it = dateRefs_.find(date);
+        if (it != dateRefs_.end()) {
+            return it->second;
+        }
+        auto &text = dateText_.emplace_back();
+        writeIsoDate(date, text.data());
+        std::uint32_t ref = add(std::string_view(text.data(), text.size()));
+        dateRefs_.emplace(date, ref);
+        return ref;
+    }
+
+    std::uint32_t ref(std::string_view value) const { return refs_.find(value)->second; }
+    std::uint32_t dateRef(DayNumber date) const { return dateRefs_.find(date)->second; }
+
+    std::uint64_t encodedSize() const {
+        return sizeof(std::uint32_t) + strings_.size() * 2 * sizeof(std::uint32_t) + bytes_;
+    }
+
+    void write(ReportWriter &out) const {
+        writeRaw(out, static_cast<std::uint32_t>(strings_.size()));
+        std::uint32_t offset = 0;
+        for (std::string_view value : strings_) {
+            writeRaw(out, offset);
+            writeRaw(out, static_cast<std::uint32_t>(value.size()));
+            offset += static_cast<std::uint32_t>(value.size());
+        }
+        for (std::string_view value : strings_) {
+            out.write(value);
+        }
+    }
+
+private:
+    std::unordered_map<std::string_view, std::uint32_t> refs_;
+    std::vector<std::string_view> strings_;
+    // Dates are stored as "YYYYMMDD" text; the deque keeps the viewed characters in place.
+    std::unordered_map<DayNumber, std::uint32_t> dateRefs_;
+    std::deque<std::array<char, kBinaryDateLength>> dateText_;
+    std::uint64_t bytes_ = 0;
+};
+
+// Adds every string of a booking to `table` and returns the size of its indexed record.
+std::size_t addRecordStrings(StringTable &table, const Booking &booking, BookingKind kind) {
+    constexpr std::size_t kRef = sizeof(std::uint32_t);
+    auto handle = [&table](std::string_view value) { table.add(value); };
+    handle(booking.getId());
+    table.addDate(booking.getFromDate());
+    table.addDate(booking.getToDate());
+    std::size_t size = 1 + 3 * kRef + sizeof(double);
+    switch (kind) {
+    case BookingKind::Flight: {
+        const auto &flight = static_cast<const FlightBooking &>(booking);
+        handle(flight.getFromAirport());
+        handle(flight.getToAirport());
+        handle(flight.getAirline());
+        return size + 3 * kRef;
+    }
+    case BookingKind::Hotel: {
+        const auto &hotel = static_cast<const HotelReservation &>(booking);
+        handle(hotel.getHotel());
+        handle(hotel.getCity());
+        return size + 2 * kRef;
+    }
+    case BookingKind::RentalCar: {
+        const auto &rental = static_cast<const RentalCarReservation &>(booking);
+        handle(rental.getPickupLocation());
+        handle(rental.getReturnLocation());
+        handle(rental.getCompany());
+        return size + 3 * kRef;
+    }
+    case BookingKind::Train:
+        break;
+    }
+    const auto &train = static_cast<const TrainTicket &>(booking);
+    handle(train.getFromStation());
+    handle(train.getToStation());
+    handle(train.getDepartureTime());
+    handle(train.getArrivalTime());
+    for (std::string_view station : train.getViaStations()) {
+        handle(station);
+    }
+    return size + 5 * kRef + train.getViaStations().size() * kRef;
+}
+
+// Writes records of the indexed layout; every string is a reference into `table`.
+class IndexedRecordWriter {
+public:
+    IndexedRecordWriter(ReportWriter &out, const StringTable &table) : out_(out), table_(table) {}
+
+    void operator()(const FlightBooking &booking) {
+        common('F', booking);
+        ref(booking.getFromAirport());
+        ref(booking.getToAirport());
+        ref(booking.getAirline());
+    }
+
+    void operator()(const HotelReservation &booking) {
+        common('H', booking);
+        ref(booking.getHotel());
+        ref(booking.getCity());
+    }
+
+    void operator()(const RentalCarReservation &booking) {
+        common('R', booking);
+        ref(booking.getPickupLocation());
+        ref(booking.getReturnLocation());
+        ref(booking.getCompany());
+    }
+
+    void operator()(const TrainTicket &booking) {
+        common('T', booking);
+        ref(booking.getFromStation());
+        ref(booking.getToStation());
+        ref(booking.getDepartureTime());
+        ref(booking.getArrivalTime());
+        writeRaw(out_, static_cast<std::uint32_t>(booking.getViaStations().size()));
+        for (std::string_view station : booking.getViaStations()) {
+            ref(station);
+        }
+    }
+
+private:
+    void common(char type, const Booking &booking) {
+        out_.write(type);
+        ref(booking.getId());
+        writeRaw(out_, booking.getPrice());
+        writeRaw(out_, table_.dateRef(booking.getFromDate()));
+        writeRaw(out_, table_.dateRef(booking.getToDate()));
+    }
+
+    void ref(std::string_view value) { writeRaw(out_, table_.ref(value)); }
+
+    ReportWriter &out_;
+    const StringTable &table_;
+};
+
+void writeIndexed(const BookingStore &store, ReportWriter &out) {
+    // First pass: string table and record offsets, so the header can be written up front.
+    StringTable table;
+    std::vector<std::uint64_t> offsets;
+    offsets.reserve(store.size());
+    std::uint64_t offset = kIndexedBinaryHeaderLength;
+    for (std::size_t row = 0; row < store.size(); ++row) {
+        offsets.push_back(offset);
+        offset += addRecordStrings(table, store.booking(row), store.kinds()[row]);
+    }
+    const std::uint64_t stringTableOffset = offset;
+    const std::uint64_t indexOffset = stringTableOffset + table.encodedSize();
+
+    out.write(std::string_view(kIndexedBinaryMagic, sizeof(kIndexedBinaryMagic)));
+    writeRaw(out, kIndexedBinaryVersion);
+    writeRaw(out, static_cast<std::uint64_t>(store.size()));
+    writeRaw(out, stringTableOffset);
+    writeRaw(out, indexOffset);
+
+    IndexedRecordWriter records(out, table);
+    store.forEach(records);
+
+    table.write(out);
+    for (std::uint64_t recordOffset : offsets) {
+        writeRaw(out, recordOffset);
+    }
+}
+} // namespace
+
+void writeBinaryBookings(const BookingStore &store, std::ostream &out, BinaryFormat format) {
+    ReportWriter writer(out);
+    if (format == BinaryFormat::Indexed) {
+        writeIndexed(store, writer);
+    } else {
+        FixedWidthWriter records(writer);
+        store.forEach(records);
+    }
+    writer.flush();
+}
@@ -2,78 +2,79 @@
 
 #include <algorithm>
 #include <cctype>
+#include <charconv>
 
-Booking::Booking(std::string id, double price, std::string fromDate, std::string toDate)
-    : id_(std::move(id)), price_(price), fromDate_(std::move(fromDate)), toDate_(std::move(toDate)) {}
+#include "ReportWriter.h"
+
+Booking::Booking(BookingKind kind, std::string_view id, double price, DayNumber fromDate, DayNumber toDate)
+    : kind_(kind), id_(id), price_(price), fromDate_(fromDate), toDate_(toDate) {}
 
 Booking::~Booking() = default;
 
-FlightBooking::FlightBooking(std::string id, double price, std::string fromDate, std::string toDate,
-                             std::string fromAirport, std::string toAirport, std::string airline)
-    : Booking(std::move(id), price, std::move(fromDate), std::move(toDate)),
-      fromAirport_(std::move(fromAirport)), toAirport_(std::move(toAirport)), airline_(std::move(airline)) {}
+void Booking::showDetails() const {
+    ReportWriter out(std::cout);
+    writeDetails(out);
+}
+
+FlightBooking::FlightBooking(std::string_view id, double price, DayNumber fromDate, DayNumber toDate,
+                             std::string_view fromAirport, std::string_view toAirport, std::string_view airline)
+    : Booking(BookingKind::Flight, id, price, fromDate, toDate),
+      fromAirport_(fromAirport), toAirport_(toAirport), airline_(airline) {}
 
-void FlightBooking::showDetails() const {
-    std::cout << "Flight " << id_ << ": " << formatDate(fromDate_) << " - " << formatDate(toDate_)
-              << ", " << fromAirport_ << " -> " << toAirport_ << ", Airline: " << airline_
-              << ", Price: " << formatPrice(price_) << '\n';
+void FlightBooking::writeDetails(ReportWriter &out) const {
+    out.write("Flight ").write(id_).write(": ").writeDate(fromDate_).write(" - ").writeDate(toDate_)
+        .write(", ").write(fromAirport_).write(" -> ").write(toAirport_).write(", Airline: ").write(airline_)
+        .write(", Price: ").writeFixed(price_).write(" Euro\n");
 }
 
-HotelReservation::HotelReservation(std::string id, double price, std::string fromDate, std::string toDate,
-                                   std::string hotel, std::string city)
-    : Booking(std::move(id), price, std::move(fromDate), std::move(toDate)), hotel_(std::move(hotel)),
-      city_(std::move(city)) {}
+HotelReservation::HotelReservation(std::string_view id, double price, DayNumber fromDate, DayNumber toDate,
+                                   std::string_view hotel, std::string_view city)
+    : Booking(BookingKind::Hotel, id, price, fromDate, toDate),
+      hotel_(hotel), city_(city) {}
 
-void HotelReservation::showDetails() const {
-    std::cout << "Hotel " << id_ << ": " << formatDate(fromDate_) << " - " << formatDate(toDate_)
-              << ", " << hotel_ << " in " << city_ << ", Price: " << formatPrice(price_) << '\n';
+void HotelReservation::writeDetails(ReportWriter &out) const {
+    out.write("Hotel ").write(id_).write(": ").writeDate(fromDate_).write(" - ").writeDate(toDate_)
+        .write(", ").write(hotel_).write(" in ").write(city_).write(", Price: ").writeFixed(price_).write(" Euro\n");
 }
 
-RentalCarReservation::RentalCarReservation(std::string id, double price, std::string fromDate, std::string toDate,
-                                           std::string pickupLocation, std::string returnLocation,
-                                           std::string company)
-    : Booking(std::move(id), price, std::move(fromDate), std::move(toDate)),
-      pickupLocation_(std::move(pickupLocation)), returnLocation_(std::move(returnLocation)),
-      company_(std::move(company)) {}
-
-void RentalCarReservation::showDetails() const {
-    std::cout << "RentalCar " << id_ << ": " << formatDate(fromDate_) << " - " << formatDate(toDate_)
-              << ", Pickup: " << pickupLocation_ << ", Return: " << returnLocation_ << ", Company: "
-              << company_ << ", Price: " << formatPrice(price_) << '\n';
+RentalCarReservation::RentalCarReservation(std::string_view id, double price, DayNumber fromDate, DayNumber toDate,
+                                           std::string_view pickupLocation, std::string_view returnLocation,
+                                           std::string_view company)
+    : Booking(BookingKind::RentalCar, id, price, fromDate, toDate),
+      pickupLocation_(pickupLocation), returnLocation_(returnLocation),
+      company_(company) {}
+
+void RentalCarReservation::writeDetails(ReportWriter &out) const {
+    out.write("RentalCar ").write(id_).write(": ").writeDate(fromDate_).write(" - ").writeDate(toDate_)
+        .write(", Pickup: ").write(pickupLocation_).write(", Return: ").write(returnLocation_)
+        .write(", Company: ").write(company_).write(", Price: ").writeFixed(price_).write(" Euro\n");
 }
 
-TrainTicket::TrainTicket(std::string id, double price, std::string fromDate, std::string toDate,
-                         std::string fromStation, std::string toStation, std::string departureTime,
-                         std::string arrivalTime, std::vector<std::string> viaStations)
-    : Booking(std::move(id), price, std::move(fromDate), std::move(toDate)),
-      fromStation_(std::move(fromStation)), toStation_(std::move(toStation)),
-      departureTime_(std::move(departureTime)), arrivalTime_(std::move(arrivalTime)),
+TrainTicket::TrainTicket(std::string_view id, double price, DayNumber fromDate, DayNumber toDate,
+                         std::string_view fromStation, std::string_view toStation, std::string_view departureTime,
+                         std::string_view arrivalTime, std::pmr::vector<std::string_view> viaStations)
+    : Booking(BookingKind::Train, id, price, fromDate, toDate),
+      fromStation_(fromStation), toStation_(toStation),
+      departureTime_(departureTime), arrivalTime_(arrivalTime),
       viaStations_(std::move(viaStations)) {}
 
-void TrainTicket::showDetails() const {
-    std::cout << "Train " << id_ << ": " << formatDate(fromDate_) << " - " << formatDate(toDate_)
-              << ", " << fromStation_ << " -> " << toStation_ << " (" << departureTime_ << " - "
-              << arrivalTime_ << ")";
-    if (!viaStations_.empty()) {
-        std::cout << " über " << joinStrings(viaStations_, ", ");
-    }
-    std::cout << ", Price: " << formatPrice(price_) << '\n';
-}
-
-std::string formatDate(const std::string &isoDate) {
-    if (isoDate.size() != 8) {
-        return isoDate;
+void TrainTicket::writeDetails(ReportWriter &out) const {
+    out.write("Train ").write(id_).write(": ").writeDate(fromDate_).write(" - ").writeDate(toDate_)
+        .write(", ").write(fromStation_).write(" -> ").write(toStation_).write(" (").write(departureTime_)
+        .write(" - ").write(arrivalTime_).write(')');
+    for (std::size_t i = 0; i < viaStations_.size(); ++i) {
+        out.write(i == 0 ? " über " : ", ").write(viaStations_[i]);
     }
-    return isoDate.substr(6, 2) + "." + isoDate.substr(4, 2) + "." + isoDate.substr(0, 4);
+    out.write(", Price: ").writeFixed(price_).write(" Euro\n");
 }
 
 std::string formatPrice(double price) {
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(2) << price << " Euro";
-    return oss.str();
+    char buffer[330];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), price, std::chars_format::fixed, 2);
+    return std::string(buffer, result.ptr) + " Euro";
 }
 
-std::string joinStrings(const std::vector<std::string> &values, const std::string &separator) {
+std::string joinStrings(const std::pmr::vector<std::string_view> &values, const std::string &separator) {
     std::ostringstream oss;
     for (std::size_t i = 0; i < values.size(); ++i) {
         if (i > 0) {
@@ -84,18 +85,32 @@ std::string joinStrings(const std::vector<std::string> &values, const std::strin
     return oss.str();
 }
 
-std::string trimSpaces(const std::string &value) {
+std::string_view trimSpaces(std::string_view value) {
     auto begin = value.find_first_not_of(' ');
-    if (begin == std::string::npos) {
-        return "";
+    if (begin == std::string_view::npos) {
+        return {};
     }
     auto end = value.find_last_not_of(' ');
     return value.substr(begin, end - begin + 1);
 }
 
-bool isAirportCode(const std::string &code) {
+bool isAirportCode(std::string_view code) {
     if (code.size() != 3) {
         return false;
     }
-    return std::all_of(code.begin(), code.end(), [](unsigned char ch) { return std::isalpha(ch); });
+    // ASCII letters only, as std::isalpha in the "C" locale, without the locale lookup.
+    return std::all_of(code.begin(), code.end(),
+                       [](unsigned char ch) { return static_cast<unsigned char>((ch | 0x20) - 'a') < 26; });
+}
+
+bool isClockTime(std::string_view time) {
+    if (time.size() != 5 || time[2] != ':') {
+        return false;
+    }
+    const auto digit = [&](std::size_t index) { return static_cast<unsigned>(time[index] - '0'); };
+    const unsigned hourTens = digit(0);
+    const unsigned hourOnes = digit(1);
+    const unsigned minuteTens = digit(3);
+    const unsigned minuteOnes = digit(4);
+    return hourTens <= 2 && hourOnes <= 9 && hourTens * 10 + hourOnes <= 23 && minuteTens <= 5 && minuteOnes <= 9;
 }
@@ -0,0 +1,389 @@
+#include "BookingExport.h"
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace {
+// Rows formatted per task of a parallel export.
+constexpr std::size_t kChunkRows = 16 * 1024;
+
+constexpr std::string_view kCsvHeader =
+    "type,id,price,fromDate,toDate,fromAirport,toAirport,airline,hotel,city,pickupLocation,returnLocation,"
+    "company,fromStation,toStation,departureTime,arrivalTime,viaStations\n";
+
+void writeJsonString(ReportWriter &out, std::string_view value) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    out.write('"');
+    std::size_t start = 0;
+    for (std::size_t i = 0; i < value.size(); ++i) {
+        const auto ch = static_cast<unsigned char>(value[i]);
+        if (ch >= 0x20 && ch != '"' && ch != '\\') {
+            continue;
+        }
+        out.write(value.substr(start, i - start));
+        switch (ch) {
+        case '"':
+            out.write("\\\"");
+            break;
+        case '\\':
+            out.write("\\\\");
+            break;
+        case '\n':
+            out.write("\\n");
+            break;
+        case '\r':
+            out.write("\\r");
+            break;
+        case '\t':
+            out.write("\\t");
+            break;
+        default:
+            out.write("\\u00").write(kHex[ch >> 4]).write(kHex[ch & 0xF]);
+            break;
+        }
+        start = i + 1;
+    }
+    out.write(value.substr(start)).write('"');
+}
+
+// Writes one JSON object per booking; every row but the first is preceded by ",\n".
+class JsonRowWriter {
+public:
+    explicit JsonRowWriter(ReportWriter &out) : out_(out) {}
+
+    void operator()(const FlightBooking &booking) {
+        field("fromAirport", booking.getFromAirport());
+        field("toAirport", booking.getToAirport());
+        field("airline", booking.getAirline());
+    }
+
+    void operator()(const HotelReservation &booking) {
+        field("hotel", booking.getHotel());
+        field("city", booking.getCity());
+    }
+
+    void operator()(const RentalCarReservation &booking) {
+        field("pickupLocation", booking.getPickupLocation());
+        field("returnLocation", booking.getReturnLocation());
+        field("company", booking.getCompany());
+    }
+
+    void operator()(const TrainTicket &booking) {
+        field("fromStation", booking.getFromStation());
+        field("toStation", booking.getToStation());
+        field("departureTime", booking.getDepartureTime());
+        field("arrivalTime", booking.getArrivalTime());
+        out_.write(",\"viaStations\":[");
+        const char *separator = "";
+        for (std::string_view station : booking.getViaStations()) {
+            out_.write(separator);
+            writeJsonString(out_, station);
+            separator = ",";
+        }
+        out_.write(']');
+    }
+
+    void row(const BookingStore &store, std::size_t row) {
+        const Booking &booking = store.booking(row);
+        out_.write(row == 0 ? "  {\"id\":" : ",\n  {\"id\":");
+        writeJsonString(out_, booking.getId());
+        out_.write(",\"price\":").writeDouble(booking.getPrice());
+        out_.write(",\"fromDate\":\"").writeIsoDate(booking.getFromDate());
+        out_.write("\",\"toDate\":\"").writeIsoDate(booking.getToDate());
+        out_.write("\",\"type\":\"").write(typeName(booking.kind())).write('"');
+        store.visit(row, *this);
+        out_.write('}');
+    }
+
+    static std::string_view typeName(BookingKind kind) {
+        switch (kind) {
+        case BookingKind::Flight:
+            return "Flight";
+        case BookingKind::Hotel:
+            return "Hotel";
+        case BookingKind::RentalCar:
+            return "RentalCar";
+        case BookingKind::Train:
+            break;
+        }
+        return "Train";
+    }
+
+private:
+    void field(std::string_view name, std::string_view value) {
+        out_.write(",\"").write(name).write("\":");
+        writeJsonString(out_, value);
+    }
+
+    ReportWriter &out_;
+};
+
+// Writes one CSV line per booking in the column order of kCsvHeader.
+class CsvRowWriter {
+public:
+    explicit CsvRowWriter(ReportWriter &out) : out_(out) {}
+
+    void operator()(const FlightBooking &booking) {
+        field(booking.getFromAirport());
+        field(booking.getToAirport());
+        field(booking.getAirline());
+        out_.write(",,,,,,,,,,\n");
+    }
+
+    void operator()(const HotelReservation &booking) {
+        out_.write(",,,");
+        field(booking.getHotel());
+        field(booking.getCity());
+        out_.write(",,,,,,,,\n");
+    }
+
+    void operator()(const RentalCarReservation &booking) {
+        out_.write(",,,,,");
+        field(booking.getPickupLocation());
+        field(booking.getReturnLocation());
+        field(booking.getCompany());
+        out_.write(",,,,,\n");
+    }
+
+    void operator()(const TrainTicket &booking) {
+        out_.write(",,,,,,,,");
+        field(booking.getFromStation());
+        field(booking.getToStation());
+        field(booking.getDepartureTime());
+        field(booking.getArrivalTime());
+        // A '|' or '\' in a station name is preceded by a '\', so the list splits unambiguously.
+        via_.clear();
+        const char *separator = "";
+        for (std::string_view station : booking.getViaStations()) {
+            via_ += separator;
+            for (char ch : station) {
+                if (ch == '|' || ch == '\\') {
+                    via_ += '\\';
+                }
+                via_ += ch;
+            }
+            separator = "|";
+        }
+        field(via_);
+        out_.write('\n');
+    }
+
+    void row(const BookingStore &store, std::size_t row) {
+        const Booking &booking = store.booking(row);
+        out_.write(JsonRowWriter::typeName(booking.kind()));
+        field(booking.getId());
+        out_.write(',').writeDouble(booking.getPrice());
+        out_.write(',').writeIsoDate(booking.getFromDate());
+        out_.write(',').writeIsoDate(booking.getToDate());
+        store.visit(row, *this);
+    }
+
+private:
+    static bool needsQuotes(std::string_view value) {
+        return value.find_first_of(",\"\r\n") != std::string_view::npos;
+    }
+
+    // Doubles the quotes of a quoted field.
+    void writeEscaped(std::string_view value) {
+        std::size_t start = 0;
+        for (std::size_t quote = value.find('"'); quote != std::string_view::npos; quote = value.find('"', start)) {
+            out_.write(value.substr(start, quote + 1 - start)).write('"');
+            start = quote + 1;
+        }
+        out_.write(value.substr(start));
+    }
+
+    // Writes ",<value>", quoted if the value needs it.
+    void field(std::string_view value) {
+        out_.write(',');
+        if (!needsQuotes(value)) {
+            out_.write(value);
+            return;
+        }
+        out_.write('"');
+        writeEscaped(value);
+        out_.write('"');
+    }
+
+    ReportWriter &out_;
+    // The escaped via stations of the current row, kept to reuse its capacity.
+    std::string via_;
+};
+
+// True if `value` is well-formed UTF-8 (RFC 3629): no overlong forms, surrogates or code points
+// above U+10FFFF, which the JSON parser of readFile rejects.
+bool isValidUtf8(std::string_view value) {
+    std::size_t i = 0;
+    while (i < value.size()) {
+        const auto lead = static_cast<unsigned char>(value[i]);
+        if (lead < 0x80) {
+            ++i;
+            continue;
+        }
+        std::size_t length = 0;
+        unsigned char low = 0x80;
+        unsigned char high = 0xBF;
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            length = 2;
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            length = 3;
+            low = lead == 0xE0 ? 0xA0 : 0x80;
+            high = lead == 0xED ? 0x9F : 0xBF;
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            length = 4;
+            low = lead == 0xF0 ? 0x90 : 0x80;
+            high = lead == 0xF4 ? 0x8F : 0xBF;
+        } else {
+            return false;
+        }
+        if (value.size() - i < length) {
+            return false;
+        }
+        // Only the first continuation byte has a narrower range.
+        for (std::size_t k = 1; k < length; ++k) {
+            const auto next = static_cast<unsigned char>(value[i + k]);
+            if (next < (k == 1 ? low : 0x80) || next > (k == 1 ? high : 0xBF)) {
+                return false;
+            }
+        }
+        i += length;
+    }
+    return true;
+}
+
+// Finds the first attribute of a booking that readFile would reject: an empty string, or text
+// that is not UTF-8.
+class JsonAttributeCheck {
+public:
+    void operator()(const FlightBooking &booking) {
+        check("fromAirport", booking.getFromAirport());
+        check("toAirport", booking.getToAirport());
+        check("airline", booking.getAirline());
+    }
+
+    void operator()(const HotelReservation &booking) {
+        check("hotel", booking.getHotel());
+        check("city", booking.getCity());
+    }
+
+    void operator()(const RentalCarReservation &booking) {
+        check("pickupLocation", booking.getPickupLocation());
+        check("returnLocation", booking.getReturnLocation());
+        check("company", booking.getCompany());
+    }
+
+    void operator()(const TrainTicket &booking) {
+        check("fromStation", booking.getFromStation());
+        check("toStation", booking.getToStation());
+        check("departureTime", booking.getDepartureTime());
+        check("arrivalTime", booking.getArrivalTime());
+        for (std::string_view station : booking.getViaStations()) {
+            if (failed_.empty() && !isValidUtf8(station)) {
+                fail("viaStations", "is not valid UTF-8");
+            }
+        }
+    }
+
+    void check(std::string_view name, std::string_view value) {
+        if (!failed_.empty()) {
+            return;
+        }
+        if (value.empty()) {
+            fail(name, "is empty");
+        } else if (!isValidUtf8(value)) {
+            fail(name, "is not valid UTF-8");
+        }
+    }
+
+    // "attribute '<name>' <reason>" for the first failed attribute, empty if all passed.
+    const std::string &failure() const { return failed_; }
+
+private:
+    void fail(std::string_view name, std::string_view reason) {
+        failed_.append("attribute '").append(name).append("' ").append(reason);
+    }
+
+    std::string failed_;
+};
+
+void writeRows(const BookingStore &store, ExportFormat format, std::size_t first, std::size_t last,
+               ReportWriter &out) {
+    if (format == ExportFormat::Json) {
+        JsonRowWriter writer(out);
+        for (std::size_t row = first; row < last; ++row) {
+            writer.row(store, row);
+        }
+    } else {
+        CsvRowWriter writer(out);
+        for (std::size_t row = first; row < last; ++row) {
+            writer.row(store, row);
+        }
+    }
+}
+
+void writeRowsParallel(const BookingStore &store, ExportFormat format, const ExportOptions &options,
+                       ReportWriter &out) {
+    ThreadPool pool(options.threadCount);
+    const std::size_t chunkCount = (store.size() + kChunkRows - 1) / kChunkRows;
+    // At most two chunks per thread are formatted ahead of the writer, which bounds the memory
+    // held by finished chunks.
+    std::deque<std::future<std::string>> pending;
+    std::size_t submitted = 0;
+    auto submit = [&]() {
+        const std::size_t first = submitted * kChunkRows;
+        const std::size_t last = std::min(first + kChunkRows, store.size());
+        pending.push_back(pool.submit([&store, format, first, last]() {
+            std::string text;
+            {
+                ReportWriter chunk(text);
+                writeRows(store, format, first, last, chunk);
+            }
+            return text;
+        }));
+        ++submitted;
+    };
+    while (submitted < chunkCount && pending.size() < 2 * pool.size()) {
+        submit();
+    }
+    while (!pending.empty()) {
+        const std::string text = pending.front().get();
+        pending.pop_front();
+        if (submitted < chunkCount) {
+            submit();
+        }
+        out.write(text);
+    }
+}
+} // namespace
+
+void validateJsonExport(const BookingStore &store) {
+    for (std::size_t row = 0; row < store.size(); ++row) {
+        const Booking &booking = store.booking(row);
+        JsonAttributeCheck check;
+        check.check("id", booking.getId());
+        store.visit(row, check);
+        if (!check.failure().empty()) {
+            throw std::runtime_error("Cannot export booking '" + std::string(booking.getId()) + "' as JSON: " +
+                                     check.failure() + " and would not read back.");
+        }
+    }
+}
+
+void exportBookings(const BookingStore &store, ReportWriter &out, ExportFormat format,
+                    const ExportOptions &options) {
+    out.write(format == ExportFormat::Json ? std::string_view("[\n") : kCsvHeader);
+    if (options.parallel && store.size() > kChunkRows) {
+        writeRowsParallel(store, format, options, out);
+    } else {
+        writeRows(store, format, 0, store.size(), out);
+    }
+    if (format == ExportFormat::Json) {
+        out.write(store.size() > 0 ? "\n]\n" : "]\n");
+    }
+}
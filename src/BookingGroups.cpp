@@ -0,0 +1,184 @@
+#include "BookingGroups.h"
+
+#include "Date.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <future>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+// Below this many rows per thread the pool costs more than it saves.
+constexpr std::size_t kMinRowsPerThread = 64 * 1024;
+
+struct Totals {
+    std::size_t count = 0;
+    double revenue = 0.0;
+};
+
+// Flights and train tickets are kept apart even where an airport and a station share a name.
+struct RouteKey {
+    bool train;
+    std::string_view from;
+    std::string_view to;
+
+    bool operator==(const RouteKey &other) const {
+        return train == other.train && from == other.from && to == other.to;
+    }
+};
+
+struct RouteHash {
+    std::size_t operator()(const RouteKey &route) const {
+        const std::size_t first = std::hash<std::string_view>()(route.from) + route.train;
+        return first ^ (std::hash<std::string_view>()(route.to) + 0x9e3779b97f4a7c15ULL + (first << 6) + (first >> 2));
+    }
+};
+
+template <class Key, class Hash>
+using GroupMap = std::unordered_map<Key, Totals, Hash>;
+
+// Aggregates entries [0, count) into a map, where `visit(i, add)` calls `add(key, price)` for entry
+// i. Each worker fills a local map over its own range; the maps are merged in range order.
+template <class Key, class Hash, class Visit>
+GroupMap<Key, Hash> aggregate(std::size_t count, std::size_t threadCount, const Visit &visit) {
+    auto aggregateRange = [&visit](std::size_t begin, std::size_t end) {
+        GroupMap<Key, Hash> groups;
+        auto add = [&groups](const Key &key, double price) {
+            Totals &totals = groups[key];
+            ++totals.count;
+            totals.revenue += price;
+        };
+        for (std::size_t i = begin; i < end; ++i) {
+            visit(i, add);
+        }
+        return groups;
+    };
+
+    if (threadCount == 0) {
+        threadCount = ThreadPool::defaultThreadCount();
+    }
+    const std::size_t ranges = std::min(threadCount, std::max<std::size_t>(1, count / kMinRowsPerThread));
+    if (ranges <= 1) {
+        return aggregateRange(0, count);
+    }
+
+    ThreadPool pool(ranges);
+    std::vector<std::future<GroupMap<Key, Hash>>> partials;
+    partials.reserve(ranges);
+    for (std::size_t range = 0; range < ranges; ++range) {
+        const std::size_t begin = count * range / ranges;
+        const std::size_t end = count * (range + 1) / ranges;
+        partials.push_back(pool.submit([&aggregateRange, begin, end]() { return aggregateRange(begin, end); }));
+    }
+    GroupMap<Key, Hash> groups = partials.front().get();
+    for (std::size_t range = 1; range < ranges; ++range) {
+        for (const auto &[key, totals] : partials[range].get()) {
+            Totals &merged = groups[key];
+            merged.count += totals.count;
+            merged.revenue += totals.revenue;
+        }
+    }
+    return groups;
+}
+
+// Aggregates one text column of a side table, weighting each entry with the price of its row.
+std::unordered_map<std::string_view, Totals> aggregateColumn(const BookingStore &store,
+                                                             const std::vector<std::string_view> &values,
+                                                             const std::vector<std::uint32_t> &rows,
+                                                             std::size_t threadCount) {
+    const auto &prices = store.prices();
+    return aggregate<std::string_view, std::hash<std::string_view>>(
+        values.size(), threadCount, [&](std::size_t i, auto &add) { add(values[i], prices[rows[i]]); });
+}
+
+template <class Map, class Format>
+std::vector<GroupTotal> toGroupTotals(const Map &groups, const Format &format) {
+    std::vector<GroupTotal> result;
+    result.reserve(groups.size());
+    for (const auto &[key, totals] : groups) {
+        result.push_back({format(key), totals.count, totals.revenue});
+    }
+    std::sort(result.begin(), result.end(), [](const GroupTotal &a, const GroupTotal &b) { return a.key < b.key; });
+    return result;
+}
+
+std::string formatRoute(const RouteKey &route) {
+    const std::string_view kind = route.train ? "Train: " : "Flight: ";
+    std::string key;
+    key.reserve(kind.size() + route.from.size() + route.to.size() + 4);
+    key.append(kind).append(route.from).append(" -> ").append(route.to);
+    return key;
+}
+
+std::string formatMonth(int months) {
+    // "YYYY-MM" for months counted from year 0.
+    char text[16];
+    int year = months / 12;
+    int month = months % 12 + 1;
+    std::snprintf(text, sizeof(text), "%04d-%02d", year, month);
+    return text;
+}
+} // namespace
+
+bool parseGroupBy(std::string_view name, GroupBy &groupBy) {
+    static const std::pair<std::string_view, GroupBy> kNames[] = {
+        {"airline", GroupBy::Airline}, {"city", GroupBy::HotelCity}, {"company", GroupBy::RentalCompany},
+        {"route", GroupBy::Route},     {"month", GroupBy::Month},
+    };
+    for (const auto &[candidate, value] : kNames) {
+        if (name == candidate) {
+            groupBy = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<GroupTotal> groupBookings(const BookingStore &store, GroupBy groupBy, std::size_t threadCount) {
+    auto copyKey = [](std::string_view key) { return std::string(key); };
+
+    switch (groupBy) {
+    case GroupBy::Airline:
+        return toGroupTotals(aggregateColumn(store, store.flights().airlines, store.flights().rows, threadCount),
+                             copyKey);
+    case GroupBy::HotelCity:
+        return toGroupTotals(aggregateColumn(store, store.hotels().cities, store.hotels().rows, threadCount), copyKey);
+    case GroupBy::RentalCompany:
+        return toGroupTotals(
+            aggregateColumn(store, store.rentalCars().companies, store.rentalCars().rows, threadCount), copyKey);
+    case GroupBy::Route: {
+        const auto &prices = store.prices();
+        const auto &flights = store.flights();
+        const auto &trains = store.trains();
+        const std::size_t flightCount = flights.rows.size();
+        // Flights first, then train tickets, as one range of entries.
+        auto groups = aggregate<RouteKey, RouteHash>(
+            flightCount + trains.rows.size(), threadCount, [&](std::size_t i, auto &add) {
+                if (i < flightCount) {
+                    add(RouteKey{false, flights.fromAirports[i], flights.toAirports[i]}, prices[flights.rows[i]]);
+                } else {
+                    i -= flightCount;
+                    add(RouteKey{true, trains.fromStations[i], trains.toStations[i]}, prices[trains.rows[i]]);
+                }
+            });
+        return toGroupTotals(groups, formatRoute);
+    }
+    case GroupBy::Month:
+        break;
+    }
+
+    const auto &prices = store.prices();
+    const auto &fromDates = store.fromDates();
+    auto groups = aggregate<int, std::hash<int>>(store.size(), threadCount, [&](std::size_t row, auto &add) {
+        int year;
+        unsigned month;
+        unsigned day;
+        civilFromDays(fromDates[row], year, month, day);
+        add(year * 12 + static_cast<int>(month) - 1, prices[row]);
+    });
+    return toGroupTotals(groups, formatMonth);
+}
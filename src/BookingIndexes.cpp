@@ -0,0 +1,225 @@
+#include "BookingIndexes.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <numeric>
+
+namespace {
+// Scanning the rows added since the interval index was built is cheaper than rebuilding it until
+// they make up this fraction of the store.
+constexpr std::size_t kUnindexedIntervalFraction = 16;
+
+// Adds the entries of a side table column that belong to rows from `firstRow` on.
+void addColumn(PostingMap &map, const std::vector<std::string_view> &values, const std::vector<std::uint32_t> &rows,
+               std::size_t firstRow) {
+    auto begin = std::lower_bound(rows.begin(), rows.end(), firstRow);
+    for (auto i = static_cast<std::size_t>(begin - rows.begin()); i < values.size(); ++i) {
+        map[values[i]].push_back(rows[i]);
+    }
+}
+
+const std::vector<std::uint32_t> &rowsOfKind(const BookingStore &store, BookingKind kind) {
+    switch (kind) {
+    case BookingKind::Flight:
+        return store.flights().rows;
+    case BookingKind::Hotel:
+        return store.hotels().rows;
+    case BookingKind::RentalCar:
+        return store.rentalCars().rows;
+    case BookingKind::Train:
+        break;
+    }
+    return store.trains().rows;
+}
+
+// Keeps the rows of `result` that also occur in `list`. Both are ascending; each lookup continues
+// from the previous match, so a short `result` costs O(|result| log |list|).
+void intersect(std::vector<std::uint32_t> &result, const std::vector<std::uint32_t> &list) {
+    auto position = list.begin();
+    auto out = result.begin();
+    for (std::uint32_t row : result) {
+        position = std::lower_bound(position, list.end(), row);
+        if (position == list.end()) {
+            break;
+        }
+        if (*position == row) {
+            *out++ = row;
+        }
+    }
+    result.erase(out, result.end());
+}
+} // namespace
+
+void BookingIndexes::findOverlapping(DayNumber from, DayNumber to, std::vector<std::uint32_t> &rows) const {
+    std::call_once(intervalsBuilt_, [this]() {
+        intervals_ = std::make_unique<IntervalIndex>(store_.fromDates(), store_.toDates());
+        intervalRows_ = store_.size();
+    });
+    intervals_->findOverlapping(from, to, rows);
+
+    const auto &fromDates = store_.fromDates();
+    const auto &toDates = store_.toDates();
+    for (std::size_t row = intervalRows_; row < store_.size(); ++row) {
+        const DayNumber start = std::min(fromDates[row], toDates[row]);
+        const DayNumber end = std::max(fromDates[row], toDates[row]);
+        if (start <= to && from <= end) {
+            rows.push_back(static_cast<std::uint32_t>(row));
+        }
+    }
+}
+
+const PostingMap &BookingIndexes::postings(Attribute attribute) const {
+    const auto slot = static_cast<std::size_t>(attribute);
+    std::call_once(postingsBuilt_[slot], [this, attribute, slot]() {
+        buildPostings(attribute, 0);
+        postingsReady_[slot] = true;
+    });
+    return postings_[slot];
+}
+
+void BookingIndexes::buildPostings(Attribute attribute, std::size_t firstRow) const {
+    PostingMap &map = postings_[static_cast<std::size_t>(attribute)];
+    switch (attribute) {
+    case Attribute::Airline:
+        addColumn(map, store_.flights().airlines, store_.flights().rows, firstRow);
+        break;
+    case Attribute::City:
+        addColumn(map, store_.hotels().cities, store_.hotels().rows, firstRow);
+        break;
+    case Attribute::Company:
+        addColumn(map, store_.rentalCars().companies, store_.rentalCars().rows, firstRow);
+        break;
+    case Attribute::FromAirport:
+        addColumn(map, store_.flights().fromAirports, store_.flights().rows, firstRow);
+        break;
+    case Attribute::ToAirport:
+        addColumn(map, store_.flights().toAirports, store_.flights().rows, firstRow);
+        break;
+    case Attribute::FromStation:
+        addColumn(map, store_.trains().fromStations, store_.trains().rows, firstRow);
+        break;
+    case Attribute::ToStation:
+        addColumn(map, store_.trains().toStations, store_.trains().rows, firstRow);
+        break;
+    }
+}
+
+const BookingIndexes::PriceIndex &BookingIndexes::priceIndex() const {
+    std::call_once(pricesBuilt_, [this]() {
+        const auto &prices = store_.prices();
+        prices_.rows.resize(prices.size());
+        std::iota(prices_.rows.begin(), prices_.rows.end(), 0u);
+        std::stable_sort(prices_.rows.begin(), prices_.rows.end(),
+                         [&prices](std::uint32_t a, std::uint32_t b) { return prices[a] < prices[b]; });
+        prices_.prices.reserve(prices.size());
+        for (std::uint32_t row : prices_.rows) {
+            prices_.prices.push_back(prices[row]);
+        }
+        pricesReady_ = true;
+    });
+    return prices_;
+}
+
+void BookingIndexes::extend() {
+    const std::size_t firstRow = rowCount_;
+    rowCount_ = store_.size();
+    if (firstRow == rowCount_) {
+        return;
+    }
+
+    for (std::size_t slot = 0; slot < kAttributeCount; ++slot) {
+        if (postingsReady_[slot]) {
+            buildPostings(static_cast<Attribute>(slot), firstRow);
+        }
+    }
+
+    if (pricesReady_) {
+        const auto &prices = store_.prices();
+        std::vector<std::uint32_t> added(rowCount_ - firstRow);
+        std::iota(added.begin(), added.end(), static_cast<std::uint32_t>(firstRow));
+        auto byPrice = [&prices](std::uint32_t a, std::uint32_t b) { return prices[a] < prices[b]; };
+        std::stable_sort(added.begin(), added.end(), byPrice);
+        std::vector<std::uint32_t> rows;
+        rows.reserve(rowCount_);
+        std::merge(prices_.rows.begin(), prices_.rows.end(), added.begin(), added.end(), std::back_inserter(rows),
+                   byPrice);
+        prices_.rows = std::move(rows);
+        prices_.prices.clear();
+        for (std::uint32_t row : prices_.rows) {
+            prices_.prices.push_back(prices[row]);
+        }
+    }
+
+    if (intervals_ && (rowCount_ - intervalRows_) * kUnindexedIntervalFraction > rowCount_) {
+        intervals_ = std::make_unique<IntervalIndex>(store_.fromDates(), store_.toDates());
+        intervalRows_ = rowCount_;
+    }
+}
+
+std::vector<std::uint32_t> BookingIndexes::find(const BookingQuery &query) const {
+    std::vector<const std::vector<std::uint32_t> *> lists;
+    if (query.kind) {
+        lists.push_back(&rowsOfKind(store_, *query.kind));
+    }
+
+    const std::pair<const std::optional<std::string> &, Attribute> filters[] = {
+        {query.airline, Attribute::Airline},         {query.city, Attribute::City},
+        {query.company, Attribute::Company},         {query.fromAirport, Attribute::FromAirport},
+        {query.toAirport, Attribute::ToAirport},     {query.fromStation, Attribute::FromStation},
+        {query.toStation, Attribute::ToStation},
+    };
+    for (const auto &[value, attribute] : filters) {
+        if (!value) {
+            continue;
+        }
+        const PostingMap &map = postings(attribute);
+        auto it = map.find(*value);
+        if (it == map.end()) {
+            return {};
+        }
+        lists.push_back(&it->second);
+    }
+    std::sort(lists.begin(), lists.end(), [](const auto *a, const auto *b) { return a->size() < b->size(); });
+
+    // The price range becomes a posting list of its own if it selects fewer rows than any
+    // equality filter; otherwise it is checked against the price column afterwards.
+    const double minPrice = query.minPrice.value_or(-std::numeric_limits<double>::infinity());
+    const double maxPrice = query.maxPrice.value_or(std::numeric_limits<double>::infinity());
+    bool checkPrices = query.minPrice || query.maxPrice;
+    std::vector<std::uint32_t> priceRows;
+    if (checkPrices) {
+        if (minPrice > maxPrice) {
+            return {};
+        }
+        const PriceIndex &index = priceIndex();
+        auto first = std::lower_bound(index.prices.begin(), index.prices.end(), minPrice);
+        auto last = std::upper_bound(first, index.prices.end(), maxPrice);
+        const auto count = static_cast<std::size_t>(last - first);
+        if (lists.empty() || count < lists.front()->size()) {
+            priceRows.assign(index.rows.begin() + (first - index.prices.begin()),
+                             index.rows.begin() + (last - index.prices.begin()));
+            std::sort(priceRows.begin(), priceRows.end());
+            lists.insert(lists.begin(), &priceRows);
+            checkPrices = false;
+        }
+    }
+
+    std::vector<std::uint32_t> result;
+    if (lists.empty()) {
+        result.resize(store_.size());
+        std::iota(result.begin(), result.end(), 0u);
+        return result;
+    }
+    result = *lists.front();
+    for (std::size_t i = 1; i < lists.size() && !result.empty(); ++i) {
+        intersect(result, *lists[i]);
+    }
+    if (checkPrices) {
+        const auto &prices = store_.prices();
+        result.erase(std::remove_if(result.begin(), result.end(),
+                                    [&](std::uint32_t row) { return prices[row] < minPrice || prices[row] > maxPrice; }),
+                     result.end());
+    }
+    return result;
+}
@@ -0,0 +1,169 @@
+#include "BookingStatistics.h"
+
+#include "ReportWriter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const double kGamma = (1.0 + PriceSketch::kRelativeAccuracy) / (1.0 - PriceSketch::kRelativeAccuracy);
+const double kLogGamma = std::log(kGamma);
+// Magnitudes below this are counted as zero; it keeps the bucket range bounded.
+constexpr double kMinMagnitude = 1e-9;
+} // namespace
+
+void PriceSketch::Buckets::add(int index, std::uint64_t count) {
+    if (counts.empty()) {
+        offset = index;
+        counts.assign(1, 0);
+    } else if (index < offset) {
+        counts.insert(counts.begin(), static_cast<std::size_t>(offset - index), 0);
+        offset = index;
+    } else if (index >= offset + static_cast<int>(counts.size())) {
+        counts.resize(static_cast<std::size_t>(index - offset) + 1, 0);
+    }
+    counts[static_cast<std::size_t>(index - offset)] += count;
+}
+
+int PriceSketch::bucketIndex(double magnitude) {
+    return static_cast<int>(std::ceil(std::log(magnitude) / kLogGamma));
+}
+
+double PriceSketch::bucketValue(int index) {
+    // Bucket `index` holds (gamma^(index-1), gamma^index]; this estimate is within the relative
+    // accuracy of every value in it.
+    return 2.0 * std::pow(kGamma, index) / (kGamma + 1.0);
+}
+
+void PriceSketch::add(double value) {
+    ++count_;
+    if (std::fabs(value) < kMinMagnitude) {
+        ++zeroCount_;
+    } else if (value > 0) {
+        positive_.add(bucketIndex(value), 1);
+    } else {
+        negative_.add(bucketIndex(-value), 1);
+    }
+}
+
+void PriceSketch::merge(const PriceSketch &other) {
+    for (std::size_t i = 0; i < other.positive_.counts.size(); ++i) {
+        if (other.positive_.counts[i] != 0) {
+            positive_.add(other.positive_.offset + static_cast<int>(i), other.positive_.counts[i]);
+        }
+    }
+    for (std::size_t i = 0; i < other.negative_.counts.size(); ++i) {
+        if (other.negative_.counts[i] != 0) {
+            negative_.add(other.negative_.offset + static_cast<int>(i), other.negative_.counts[i]);
+        }
+    }
+    zeroCount_ += other.zeroCount_;
+    count_ += other.count_;
+}
+
+void PriceSketch::clear() {
+    positive_ = {};
+    negative_ = {};
+    zeroCount_ = 0;
+    count_ = 0;
+}
+
+double PriceSketch::quantile(double q) const {
+    if (count_ == 0) {
+        return 0.0;
+    }
+    q = std::clamp(q, 0.0, 1.0);
+    const auto rank = static_cast<std::uint64_t>(q * static_cast<double>(count_ - 1));
+
+    // Walk the buckets in ascending value order: large negative magnitudes first.
+    std::uint64_t seen = 0;
+    for (std::size_t i = negative_.counts.size(); i-- > 0;) {
+        seen += negative_.counts[i];
+        if (seen > rank) {
+            return -bucketValue(negative_.offset + static_cast<int>(i));
+        }
+    }
+    seen += zeroCount_;
+    if (seen > rank) {
+        return 0.0;
+    }
+    for (std::size_t i = 0; i < positive_.counts.size(); ++i) {
+        seen += positive_.counts[i];
+        if (seen > rank) {
+            return bucketValue(positive_.offset + static_cast<int>(i));
+        }
+    }
+    return bucketValue(positive_.offset + static_cast<int>(positive_.counts.size()) - 1);
+}
+
+void KindStatistics::add(double price) {
+    if (count == 0) {
+        min = price;
+        max = price;
+    } else {
+        min = std::min(min, price);
+        max = std::max(max, price);
+    }
+    ++count;
+    sum += price;
+    prices.add(price);
+}
+
+void KindStatistics::merge(const KindStatistics &other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        min = other.min;
+        max = other.max;
+    } else {
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+    count += other.count;
+    sum += other.sum;
+    prices.merge(other.prices);
+}
+
+double KindStatistics::quantile(double q) const {
+    if (count == 0) {
+        return 0.0;
+    }
+    if (q <= 0.0) {
+        return min;
+    }
+    if (q >= 1.0) {
+        return max;
+    }
+    return std::clamp(prices.quantile(q), min, max);
+}
+
+void BookingStatistics::add(BookingKind kind, double price) {
+    kinds_[static_cast<std::size_t>(kind)].add(price);
+    total_.add(price);
+}
+
+void BookingStatistics::merge(const BookingStatistics &other) {
+    for (std::size_t kind = 0; kind < kinds_.size(); ++kind) {
+        kinds_[kind].merge(other.kinds_[kind]);
+    }
+    total_.merge(other.total_);
+}
+
+void BookingStatistics::clear() {
+    *this = BookingStatistics();
+}
+
+void writeStatistics(const BookingStatistics &stats, ReportWriter &out) {
+    auto writeKind = [&](const char *label, BookingKind kind) {
+        const KindStatistics &kindStats = stats.forKind(kind);
+        out.write(label).writeInt(static_cast<long long>(kindStats.count)).write(" (");
+        out.writeFixed(kindStats.sum).write(" Euro)");
+    };
+
+    writeKind("Flights: ", BookingKind::Flight);
+    writeKind(", RentalCars: ", BookingKind::RentalCar);
+    writeKind(", Hotels: ", BookingKind::Hotel);
+    writeKind(", Trains: ", BookingKind::Train);
+    out.write('\n');
+}
@@ -0,0 +1,66 @@
+#include "BookingStore.h"
+
+void BookingStore::append(const Booking &booking) {
+    const auto row = static_cast<std::uint32_t>(kinds_.size());
+    kinds_.push_back(booking.kind());
+    prices_.push_back(booking.getPrice());
+    fromDates_.push_back(booking.getFromDate());
+    toDates_.push_back(booking.getToDate());
+    bookings_.push_back(&booking);
+
+    switch (booking.kind()) {
+    case BookingKind::Flight: {
+        const auto &flight = static_cast<const FlightBooking &>(booking);
+        sideRows_.push_back(static_cast<std::uint32_t>(flights_.rows.size()));
+        flights_.rows.push_back(row);
+        flights_.fromAirports.push_back(flight.getFromAirport());
+        flights_.toAirports.push_back(flight.getToAirport());
+        flights_.airlines.push_back(flight.getAirline());
+        break;
+    }
+    case BookingKind::Hotel: {
+        const auto &hotel = static_cast<const HotelReservation &>(booking);
+        sideRows_.push_back(static_cast<std::uint32_t>(hotels_.rows.size()));
+        hotels_.rows.push_back(row);
+        hotels_.hotels.push_back(hotel.getHotel());
+        hotels_.cities.push_back(hotel.getCity());
+        break;
+    }
+    case BookingKind::RentalCar: {
+        const auto &rental = static_cast<const RentalCarReservation &>(booking);
+        sideRows_.push_back(static_cast<std::uint32_t>(rentalCars_.rows.size()));
+        rentalCars_.rows.push_back(row);
+        rentalCars_.pickupLocations.push_back(rental.getPickupLocation());
+        rentalCars_.returnLocations.push_back(rental.getReturnLocation());
+        rentalCars_.companies.push_back(rental.getCompany());
+        break;
+    }
+    case BookingKind::Train: {
+        const auto &train = static_cast<const TrainTicket &>(booking);
+        sideRows_.push_back(static_cast<std::uint32_t>(trains_.rows.size()));
+        trains_.rows.push_back(row);
+        trains_.fromStations.push_back(train.getFromStation());
+        trains_.toStations.push_back(train.getToStation());
+        trains_.departureTimes.push_back(train.getDepartureTime());
+        trains_.arrivalTimes.push_back(train.getArrivalTime());
+        for (const auto &station : train.getViaStations()) {
+            trains_.viaStations.push_back(station);
+        }
+        trains_.viaOffsets.push_back(static_cast<std::uint32_t>(trains_.viaStations.size()));
+        break;
+    }
+    }
+}
+
+void BookingStore::reserve(std::size_t count) {
+    kinds_.reserve(count);
+    prices_.reserve(count);
+    fromDates_.reserve(count);
+    toDates_.reserve(count);
+    sideRows_.reserve(count);
+    bookings_.reserve(count);
+}
+
+void BookingStore::clear() {
+    *this = BookingStore();
+}
@@ -0,0 +1,63 @@
+#include "ConcurrentTravelAgency.h"
+
+#include <thread>
+#include <utility>
+
+ConcurrentTravelAgency::ConcurrentTravelAgency() {
+    slots_[0] = std::make_shared<const TravelAgency>();
+}
+
+// All atomics use sequential consistency: a reader's increment of readers_[i] followed by its
+// load of active_, against publish's store of active_ followed by its load of readers_[i], must
+// not both miss each other.
+std::shared_ptr<const TravelAgency> ConcurrentTravelAgency::snapshot() const {
+    while (true) {
+        const unsigned slot = active_.load();
+        readers_[slot].fetch_add(1);
+        // If a load switched slots in between, the slot may be emptied or refilled any moment.
+        if (active_.load() == slot) {
+            std::shared_ptr<const TravelAgency> current = slots_[slot];
+            readers_[slot].fetch_sub(1);
+            return current;
+        }
+        readers_[slot].fetch_sub(1);
+    }
+}
+
+void ConcurrentTravelAgency::waitForReaders(const std::atomic<std::size_t> &readers) {
+    // A reader holds its count only for a shared_ptr copy.
+    while (readers.load() != 0) {
+        std::this_thread::yield();
+    }
+}
+
+void ConcurrentTravelAgency::publish(std::shared_ptr<const TravelAgency> agency) {
+    const unsigned previous = active_.load();
+    const unsigned next = 1 - previous;
+    slots_[next] = std::move(agency);
+    active_.store(next);
+    // Readers that counted themselves after the switch see it and leave the previous slot alone;
+    // once the others are done, it is emptied. The previous snapshot is destroyed by whichever
+    // thread drops the last reference to it.
+    waitForReaders(readers_[previous]);
+    slots_[previous].reset();
+}
+
+void ConcurrentTravelAgency::readFile(const std::string &path, const LoadOptions &options) {
+    std::lock_guard<std::mutex> lock(loadMutex_);
+    auto agency = std::make_shared<TravelAgency>();
+    agency->readFile(path, options);
+    publish(std::move(agency));
+}
+
+void ConcurrentTravelAgency::readBinaryFile(const std::string &path, const LoadOptions &options) {
+    std::lock_guard<std::mutex> lock(loadMutex_);
+    auto agency = std::make_shared<TravelAgency>();
+    agency->readBinaryFile(path, options);
+    publish(std::move(agency));
+}
+
+void ConcurrentTravelAgency::clear() {
+    std::lock_guard<std::mutex> lock(loadMutex_);
+    publish(std::make_shared<const TravelAgency>());
+}
@@ -0,0 +1,99 @@
+#include "Date.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace {
+bool isLeapYear(int year) {
+    return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+}
+
+unsigned daysInMonth(int year, unsigned month) {
+    static constexpr unsigned kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return month == 2 && isLeapYear(year) ? 29 : kDays[month - 1];
+}
+
+void writeDigits(unsigned value, char *out, int width) {
+    for (int i = width - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+} // namespace
+
+// Howard Hinnant's days_from_civil / civil_from_days.
+DayNumber daysFromCivil(int year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const auto yearOfEra = static_cast<unsigned>(year - era * 400);
+    const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<int>(dayOfEra) - 719468;
+}
+
+void civilFromDays(DayNumber days, int &year, unsigned &month, unsigned &day) {
+    days += 719468;
+    const int era = (days >= 0 ? days : days - 146096) / 146097;
+    const auto dayOfEra = static_cast<unsigned>(days - era * 146097);
+    const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const unsigned monthIndex = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    year = static_cast<int>(yearOfEra) + era * 400 + (month <= 2);
+}
+
+bool parseIsoDate(std::string_view text, DayNumber &days) {
+    if (text.size() != 8) {
+        return false;
+    }
+    // All eight bytes are digits if every high nibble is 3 and adding 6 to every byte leaves the
+    // high nibbles at 3. With high nibbles of 3 the additions cannot carry into the next byte.
+    std::uint64_t word = 0;
+    std::memcpy(&word, text.data(), sizeof(word));
+    constexpr std::uint64_t kHighNibbles = 0xF0F0F0F0F0F0F0F0ULL;
+    constexpr std::uint64_t kZeros = 0x3030303030303030ULL;
+    if ((word & kHighNibbles) != kZeros || ((word + 0x0606060606060606ULL) & kHighNibbles) != kZeros) {
+        return false;
+    }
+    unsigned digits[8];
+    for (std::size_t i = 0; i < 8; ++i) {
+        digits[i] = static_cast<unsigned>(text[i] - '0');
+    }
+    const int year = static_cast<int>(digits[0] * 1000 + digits[1] * 100 + digits[2] * 10 + digits[3]);
+    const unsigned month = digits[4] * 10 + digits[5];
+    const unsigned day = digits[6] * 10 + digits[7];
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month)) {
+        return false;
+    }
+    days = daysFromCivil(year, month, day);
+    return true;
+}
+
+void writeIsoDate(DayNumber days, char *out) {
+    int year = 0;
+    unsigned month = 0;
+    unsigned day = 0;
+    civilFromDays(days, year, month, day);
+    writeDigits(static_cast<unsigned>(year), out, 4);
+    writeDigits(month, out + 4, 2);
+    writeDigits(day, out + 6, 2);
+}
+
+void writeDisplayDate(DayNumber days, char *out) {
+    int year = 0;
+    unsigned month = 0;
+    unsigned day = 0;
+    civilFromDays(days, year, month, day);
+    writeDigits(day, out, 2);
+    out[2] = '.';
+    writeDigits(month, out + 3, 2);
+    out[5] = '.';
+    writeDigits(static_cast<unsigned>(year), out + 6, 4);
+}
+
+std::string formatDate(DayNumber days) {
+    std::string text(10, '.');
+    writeDisplayDate(days, text.data());
+    return text;
+}
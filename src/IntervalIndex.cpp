@@ -0,0 +1,107 @@
+#include "IntervalIndex.h"
+
+#include <algorithm>
+#include <utility>
+
+IntervalIndex::IntervalIndex(const std::vector<DayNumber> &fromDates, const std::vector<DayNumber> &toDates) {
+    std::vector<Interval> intervals;
+    intervals.reserve(fromDates.size());
+    for (std::size_t row = 0; row < fromDates.size(); ++row) {
+        intervals.push_back({std::min(fromDates[row], toDates[row]), std::max(fromDates[row], toDates[row]),
+                             static_cast<std::uint32_t>(row)});
+    }
+    sortedByStart_ = intervals;
+    std::sort(sortedByStart_.begin(), sortedByStart_.end(),
+              [](const Interval &a, const Interval &b) { return a.start < b.start; });
+    byStart_.reserve(intervals.size());
+    byEnd_.reserve(intervals.size());
+    build(intervals);
+}
+
+std::int32_t IntervalIndex::build(std::vector<Interval> &intervals) {
+    if (intervals.empty()) {
+        return -1;
+    }
+
+    // The median endpoint leaves at most half of the intervals on either side.
+    std::vector<DayNumber> endpoints;
+    endpoints.reserve(intervals.size() * 2);
+    for (const Interval &interval : intervals) {
+        endpoints.push_back(interval.start);
+        endpoints.push_back(interval.end);
+    }
+    auto middle = endpoints.begin() + static_cast<std::ptrdiff_t>(endpoints.size() / 2);
+    std::nth_element(endpoints.begin(), middle, endpoints.end());
+    const DayNumber center = *middle;
+
+    std::vector<Interval> left;
+    std::vector<Interval> right;
+    const auto begin = static_cast<std::uint32_t>(byStart_.size());
+    for (const Interval &interval : intervals) {
+        if (interval.end < center) {
+            left.push_back(interval);
+        } else if (interval.start > center) {
+            right.push_back(interval);
+        } else {
+            byStart_.push_back(interval);
+            byEnd_.push_back(interval);
+        }
+    }
+    std::sort(byStart_.begin() + begin, byStart_.end(),
+              [](const Interval &a, const Interval &b) { return a.start < b.start; });
+    std::sort(byEnd_.begin() + begin, byEnd_.end(), [](const Interval &a, const Interval &b) { return a.end > b.end; });
+    intervals.clear();
+    intervals.shrink_to_fit();
+
+    const auto index = static_cast<std::int32_t>(nodes_.size());
+    nodes_.push_back({center, begin, static_cast<std::uint32_t>(byStart_.size()) - begin, -1, -1});
+    std::int32_t leftChild = build(left);
+    std::int32_t rightChild = build(right);
+    nodes_[static_cast<std::size_t>(index)].left = leftChild;
+    nodes_[static_cast<std::size_t>(index)].right = rightChild;
+    return index;
+}
+
+void IntervalIndex::findOverlapping(DayNumber from, DayNumber to, std::vector<std::uint32_t> &rows) const {
+    if (to < from) {
+        std::swap(from, to);
+    }
+
+    // Intervals starting inside [from, to].
+    auto first = std::lower_bound(sortedByStart_.begin(), sortedByStart_.end(), from,
+                                  [](const Interval &interval, DayNumber day) { return interval.start < day; });
+    for (auto it = first; it != sortedByStart_.end() && it->start <= to; ++it) {
+        rows.push_back(it->row);
+    }
+
+    // Intervals starting before `from` and running at least until `from`. Every scanned entry
+    // either is reported here or starts on `from` and was reported above.
+    std::int32_t node = nodes_.empty() ? -1 : 0;
+    while (node >= 0) {
+        const Node &current = nodes_[static_cast<std::size_t>(node)];
+        const Interval *start = byStart_.data() + current.begin;
+        const Interval *end = byEnd_.data() + current.begin;
+        if (from < current.center) {
+            for (std::uint32_t i = 0; i < current.count && start[i].start <= from; ++i) {
+                if (start[i].start < from) {
+                    rows.push_back(start[i].row);
+                }
+            }
+            node = current.left;
+        } else if (from > current.center) {
+            for (std::uint32_t i = 0; i < current.count && end[i].end >= from; ++i) {
+                if (end[i].start < from) {
+                    rows.push_back(end[i].row);
+                }
+            }
+            node = current.right;
+        } else {
+            for (std::uint32_t i = 0; i < current.count; ++i) {
+                if (start[i].start < from) {
+                    rows.push_back(start[i].row);
+                }
+            }
+            node = -1;
+        }
+    }
+}
@@ -0,0 +1,484 @@
+#include "JsonBookingReader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <streambuf>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace {
+
+// Buffers an underlying stream and counts the newlines the parser has consumed so far. Lines are
+// counted lazily over the bytes between two queries, which keeps the total work linear.
+class LineCountingBuffer : public std::streambuf {
+public:
+    explicit LineCountingBuffer(std::streambuf &source) : source_(source), buffer_(64 * 1024) {
+        setg(buffer_.data(), buffer_.data(), buffer_.data());
+        counted_ = buffer_.data();
+    }
+
+    // Line of the last character handed to the parser. If `excludeLast` is set, that character is
+    // treated as not yet consumed (the lexer reads one character past the end of a number).
+    std::size_t line(bool excludeLast = false) {
+        countUpTo(gptr());
+        if (excludeLast && gptr() > eback() && gptr()[-1] == '\n') {
+            return line_ - 1;
+        }
+        return line_;
+    }
+
+protected:
+    int_type underflow() override {
+        countUpTo(egptr());
+        std::streamsize count = source_.sgetn(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        if (count <= 0) {
+            setg(buffer_.data(), buffer_.data(), buffer_.data());
+            counted_ = buffer_.data();
+            return traits_type::eof();
+        }
+        setg(buffer_.data(), buffer_.data(), buffer_.data() + count);
+        counted_ = buffer_.data();
+        return traits_type::to_int_type(*gptr());
+    }
+
+private:
+    void countUpTo(const char *position) {
+        line_ += static_cast<std::size_t>(std::count(counted_, position, '\n'));
+        counted_ = position;
+    }
+
+    std::streambuf &source_;
+    std::vector<char> buffer_;
+    const char *counted_ = nullptr;
+    std::size_t line_ = 1;
+};
+
+// SAX consumer that locates the bookings array and builds one DOM value per array element.
+class BookingSaxHandler {
+public:
+    BookingSaxHandler(LineCountingBuffer &lines, const BookingElementHandler &handler)
+        : lines_(lines), handler_(handler) {}
+
+    bool null() { return scalar(json(nullptr)); }
+    bool boolean(bool value) { return scalar(json(value)); }
+    bool number_integer(json::number_integer_t value) { return scalar(json(value), true); }
+    bool number_unsigned(json::number_unsigned_t value) { return scalar(json(value), true); }
+    bool number_float(json::number_float_t value, const json::string_t &) { return scalar(json(value), true); }
+    bool string(json::string_t &value) { return scalar(json(std::move(value))); }
+    bool binary(json::binary_t &value) { return scalar(json(json::binary_t(std::move(value)))); }
+
+    bool start_object(std::size_t) { return startContainer(json::object()); }
+    bool start_array(std::size_t) { return startContainer(json::array()); }
+    bool end_object() { return endContainer(); }
+    bool end_array() { return endContainer(); }
+
+    bool key(json::string_t &value) {
+        if (!stack_.empty()) {
+            key_ = std::move(value);
+        } else if (depth_ == 1) {
+            rootKey_ = std::move(value);
+        }
+        return true;
+    }
+
+    template <class Exception>
+    bool parse_error(std::size_t, const std::string &, const Exception &ex) {
+        throw ex;
+    }
+
+    bool containsBookings() const { return rootIsArray_ || (rootIsObject_ && bookingsIsArray_); }
+
+private:
+    bool atElementLevel() const { return arrayDepth_ != 0 && depth_ == arrayDepth_; }
+
+    bool atBookingsValue() const { return depth_ == 1 && rootIsObject_ && rootKey_ == "bookings"; }
+
+    json *addToParent(json &&value) {
+        json &parent = *stack_.back();
+        if (parent.is_array()) {
+            parent.push_back(std::move(value));
+            return &parent.back();
+        }
+        json &slot = parent[key_];
+        slot = std::move(value);
+        return &slot;
+    }
+
+    bool scalar(json &&value, bool isNumber = false) {
+        if (!stack_.empty()) {
+            addToParent(std::move(value));
+        } else if (atElementLevel()) {
+            handler_(value, lines_.line(isNumber));
+        } else if (atBookingsValue()) {
+            bookingsIsArray_ = false;
+        }
+        return true;
+    }
+
+    bool startContainer(json &&container) {
+        if (!stack_.empty()) {
+            stack_.push_back(addToParent(std::move(container)));
+        } else if (atElementLevel()) {
+            element_ = std::move(container);
+            elementLine_ = lines_.line();
+            stack_.push_back(&element_);
+        } else if (depth_ == 0) {
+            rootIsArray_ = container.is_array();
+            rootIsObject_ = container.is_object();
+            if (rootIsArray_) {
+                arrayDepth_ = 1;
+            }
+        } else if (atBookingsValue()) {
+            bookingsIsArray_ = container.is_array();
+            if (bookingsIsArray_) {
+                arrayDepth_ = 2;
+            }
+        }
+        ++depth_;
+        return true;
+    }
+
+    bool endContainer() {
+        --depth_;
+        if (!stack_.empty()) {
+            stack_.pop_back();
+            if (stack_.empty()) {
+                handler_(element_, elementLine_);
+                element_ = json();
+            }
+        } else if (depth_ + 1 == arrayDepth_) {
+            arrayDepth_ = 0;
+        }
+        return true;
+    }
+
+    LineCountingBuffer &lines_;
+    const BookingElementHandler &handler_;
+
+    std::size_t depth_ = 0;
+    std::size_t arrayDepth_ = 0;
+    bool rootIsArray_ = false;
+    bool rootIsObject_ = false;
+    bool bookingsIsArray_ = false;
+    std::string rootKey_;
+
+    json element_;
+    std::size_t elementLine_ = 1;
+    std::vector<json *> stack_;
+    std::string key_;
+};
+
+// Structural scanner behind extractTopLevelArrayObjects. It only matches brackets and strings;
+// the contents of each element are left to the JSON parser.
+class ArraySplitter {
+public:
+    explicit ArraySplitter(std::string_view text) : text_(text) {}
+
+    bool split(std::vector<ObjectRange> &ranges) {
+        skipWhitespace();
+        if (peek() == '[') {
+            if (!splitArray(ranges)) {
+                return false;
+            }
+        } else if (peek() == '{') {
+            if (!splitRootObject(ranges)) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+        skipWhitespace();
+        return pos_ == text_.size();
+    }
+
+private:
+    char peek() const { return pos_ < text_.size() ? text_[pos_] : '\0'; }
+
+    void skipWhitespace() {
+        while (pos_ < text_.size()) {
+            char ch = text_[pos_];
+            if (ch == '\n') {
+                ++line_;
+            } else if (ch != ' ' && ch != '\t' && ch != '\r') {
+                return;
+            }
+            ++pos_;
+        }
+    }
+
+    // Skips a string, object or array starting at the current position.
+    bool skipContainerOrString() {
+        int depth = 0;
+        bool inString = false;
+        bool escape = false;
+        for (; pos_ < text_.size(); ++pos_) {
+            char ch = text_[pos_];
+            if (ch == '\n') {
+                ++line_;
+            }
+            if (inString) {
+                if (escape) {
+                    escape = false;
+                } else if (ch == '\\') {
+                    escape = true;
+                } else if (ch == '"') {
+                    inString = false;
+                    if (depth == 0) {
+                        ++pos_;
+                        return true;
+                    }
+                }
+                continue;
+            }
+            if (ch == '"') {
+                inString = true;
+            } else if (ch == '{' || ch == '[') {
+                ++depth;
+            } else if (ch == '}' || ch == ']') {
+                if (--depth == 0) {
+                    ++pos_;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool skipValue() {
+        char ch = peek();
+        if (ch == '"' || ch == '{' || ch == '[') {
+            return skipContainerOrString();
+        }
+        std::size_t start = pos_;
+        while (pos_ < text_.size()) {
+            ch = text_[pos_];
+            if (ch == ',' || ch == '}' || ch == ']' || ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n') {
+                break;
+            }
+            ++pos_;
+        }
+        return pos_ > start;
+    }
+
+    bool splitArray(std::vector<ObjectRange> &ranges) {
+        ++pos_;
+        skipWhitespace();
+        if (peek() == ']') {
+            ++pos_;
+            return true;
+        }
+        while (true) {
+            if (peek() != '{') {
+                return false;
+            }
+            std::size_t start = pos_;
+            std::size_t line = line_;
+            if (!skipContainerOrString()) {
+                return false;
+            }
+            ranges.push_back({start, pos_ - 1, line});
+            skipWhitespace();
+            if (peek() == ']') {
+                ++pos_;
+                return true;
+            }
+            if (peek() != ',') {
+                return false;
+            }
+            ++pos_;
+            skipWhitespace();
+        }
+    }
+
+    bool splitRootObject(std::vector<ObjectRange> &ranges) {
+        bool foundBookings = false;
+        ++pos_;
+        skipWhitespace();
+        if (peek() == '}') {
+            return false;
+        }
+        while (true) {
+            if (peek() != '"') {
+                return false;
+            }
+            std::size_t keyStart = pos_;
+            if (!skipContainerOrString()) {
+                return false;
+            }
+            std::string_view key = text_.substr(keyStart, pos_ - keyStart);
+            skipWhitespace();
+            if (peek() != ':') {
+                return false;
+            }
+            ++pos_;
+            skipWhitespace();
+            if (key == "\"bookings\"") {
+                if (foundBookings || peek() != '[' || !splitArray(ranges)) {
+                    return false;
+                }
+                foundBookings = true;
+            } else {
+                std::size_t valueStart = pos_;
+                if (!skipValue() || !json::accept(text_.substr(valueStart, pos_ - valueStart))) {
+                    return false;
+                }
+            }
+            skipWhitespace();
+            if (peek() == '}') {
+                ++pos_;
+                return foundBookings;
+            }
+            if (peek() != ',') {
+                return false;
+            }
+            ++pos_;
+            skipWhitespace();
+        }
+    }
+
+    std::string_view text_;
+    std::size_t pos_ = 0;
+    std::size_t line_ = 1;
+};
+
+const std::string &requireString(const json &value, const std::string &key, const std::string &path,
+                                 std::size_t lineNumber) {
+    if (!value.contains(key)) {
+        throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Missing attribute '" + key + "'.");
+    }
+    if (!value[key].is_string()) {
+        throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Attribute '" + key + "' must be a string.");
+    }
+    const auto &result = value[key].get_ref<const std::string &>();
+    if (result.empty()) {
+        throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Attribute '" + key + "' must not be empty.");
+    }
+    return result;
+}
+
+DayNumber requireDate(const json &value, const std::string &key, const std::string &path, std::size_t lineNumber) {
+    DayNumber date = 0;
+    if (!parseIsoDate(requireString(value, key, path, lineNumber), date)) {
+        throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Attribute '" + key +
+                                 "' must be a valid date in YYYYMMDD format.");
+    }
+    return date;
+}
+
+double requirePrice(const json &value, const std::string &path, std::size_t lineNumber) {
+    if (!value.contains("price")) {
+        throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Missing attribute 'price'.");
+    }
+    if (!value["price"].is_number()) {
+        throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Attribute 'price' must be numeric.");
+    }
+    double price = value["price"].get<double>();
+    if (!std::isfinite(price)) {
+        throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Attribute 'price' must be finite.");
+    }
+    return price;
+}
+
+std::pmr::vector<std::string_view> requireStringArray(const json &value, const std::string &key,
+                                                      const std::string &path, std::size_t lineNumber,
+                                                      BookingArena &arena, StringPool &strings) {
+    if (!value.contains(key)) {
+        throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Missing attribute '" + key + "'.");
+    }
+    if (!value[key].is_array()) {
+        throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Attribute '" + key + "' must be an array.");
+    }
+    std::pmr::vector<std::string_view> result(arena.resource());
+    result.reserve(value[key].size());
+    for (const auto &entry : value[key]) {
+        if (!entry.is_string()) {
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Entries in '" + key + "' must be strings.");
+        }
+        result.push_back(strings.intern(entry.get_ref<const std::string &>()));
+    }
+    return result;
+}
+
+} // namespace
+
+void readJsonBookingStream(std::istream &in, const std::string &path, const BookingElementHandler &handler) {
+    LineCountingBuffer lines(*in.rdbuf());
+    std::istream stream(&lines);
+    BookingSaxHandler sax(lines, handler);
+
+    try {
+        json::sax_parse(stream, &sax);
+    } catch (const json::parse_error &ex) {
+        throw std::runtime_error(path + ":" + std::to_string(ex.byte) + ": JSON parse error: " + std::string(ex.what()));
+    }
+
+    if (!sax.containsBookings()) {
+        throw std::runtime_error(path + ":1: JSON must contain an array of bookings.");
+    }
+}
+
+bool extractTopLevelArrayObjects(std::string_view content, std::vector<ObjectRange> &ranges) {
+    ranges.clear();
+    ArraySplitter splitter(content);
+    return splitter.split(ranges);
+}
+
+const std::string &requireBookingId(const json &element, const std::string &path, std::size_t lineNumber) {
+    if (!element.is_object()) {
+        throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Booking entry must be an object.");
+    }
+    return requireString(element, "id", path, lineNumber);
+}
+
+BookingPtr makeBookingFromJson(const json &element, std::string_view id, const std::string &path,
+                               std::size_t lineNumber, BookingArena &arena, StringPool &strings) {
+    const std::string &type = requireString(element, "type", path, lineNumber);
+    double price = requirePrice(element, path, lineNumber);
+    DayNumber fromDate = requireDate(element, "fromDate", path, lineNumber);
+    DayNumber toDate = requireDate(element, "toDate", path, lineNumber);
+
+    if (type == "Flight") {
+        const std::string &fromAirport = requireString(element, "fromAirport", path, lineNumber);
+        const std::string &toAirport = requireString(element, "toAirport", path, lineNumber);
+        if (!isAirportCode(fromAirport) || !isAirportCode(toAirport)) {
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Airport codes must have exactly three alphabetic characters.");
+        }
+        const std::string &airline = requireString(element, "airline", path, lineNumber);
+        return arena.create<FlightBooking>(arena.copy(id), price, fromDate, toDate,
+                                           strings.intern(fromAirport), strings.intern(toAirport),
+                                           strings.intern(airline));
+    }
+    if (type == "Hotel") {
+        const std::string &hotel = requireString(element, "hotel", path, lineNumber);
+        const std::string &city = requireString(element, "city", path, lineNumber);
+        return arena.create<HotelReservation>(arena.copy(id), price, fromDate, toDate,
+                                              strings.intern(hotel), strings.intern(city));
+    }
+    if (type == "RentalCar") {
+        const std::string &pickup = requireString(element, "pickupLocation", path, lineNumber);
+        const std::string &dropoff = requireString(element, "returnLocation", path, lineNumber);
+        const std::string &company = requireString(element, "company", path, lineNumber);
+        return arena.create<RentalCarReservation>(arena.copy(id), price, fromDate, toDate,
+                                                  strings.intern(pickup), strings.intern(dropoff),
+                                                  strings.intern(company));
+    }
+    if (type == "Train") {
+        const std::string &fromStation = requireString(element, "fromStation", path, lineNumber);
+        const std::string &toStation = requireString(element, "toStation", path, lineNumber);
+        const std::string &departure = requireString(element, "departureTime", path, lineNumber);
+        const std::string &arrival = requireString(element, "arrivalTime", path, lineNumber);
+        if (!isClockTime(departure) || !isClockTime(arrival)) {
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Times must have the form HH:MM.");
+        }
+        auto viaStations = element.contains("viaStations")
+                               ? requireStringArray(element, "viaStations", path, lineNumber, arena, strings)
+                               : std::pmr::vector<std::string_view>(arena.resource());
+        return arena.create<TrainTicket>(arena.copy(id), price, fromDate, toDate,
+                                         strings.intern(fromStation), strings.intern(toStation),
+                                         strings.intern(departure), strings.intern(arrival),
+                                         std::move(viaStations));
+    }
+    throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Unknown booking type '" + type + "'.");
+}
@@ -0,0 +1,94 @@
+#include "LoadMetrics.h"
+
+#include "json.hpp"
+
+const char *loadPhaseName(LoadPhase phase) {
+    switch (phase) {
+    case LoadPhase::Open:
+        return "open";
+    case LoadPhase::Scan:
+        return "scan";
+    case LoadPhase::Parse:
+        return "parse";
+    case LoadPhase::Build:
+        return "build";
+    case LoadPhase::DuplicateCheck:
+        return "duplicateCheck";
+    case LoadPhase::Insert:
+        return "insert";
+    case LoadPhase::Snapshot:
+        break;
+    }
+    return "snapshot";
+}
+
+std::uint64_t LoadMetrics::totalRecords() const {
+    std::uint64_t total = 0;
+    for (std::uint64_t count : records) {
+        total += count;
+    }
+    return total;
+}
+
+double LoadMetrics::recordsPerSecond() const {
+    return wallSeconds > 0.0 ? static_cast<double>(totalRecords()) / wallSeconds : 0.0;
+}
+
+double LoadMetrics::megabytesPerSecond() const {
+    return wallSeconds > 0.0 ? static_cast<double>(bytesRead) / wallSeconds / 1e6 : 0.0;
+}
+
+std::string LoadMetrics::toJson() const {
+    nlohmann::ordered_json phases = nlohmann::ordered_json::object();
+    for (std::size_t phase = 0; phase < kLoadPhaseCount; ++phase) {
+        phases[loadPhaseName(static_cast<LoadPhase>(phase))] = phaseSeconds[phase];
+    }
+    nlohmann::ordered_json result = {
+        {"enabled", enabled},
+        {"wallSeconds", wallSeconds},
+        {"phaseSeconds", phases},
+        {"bytesRead", bytesRead},
+        {"records",
+         {{"flights", recordCount(BookingKind::Flight)},
+          {"hotels", recordCount(BookingKind::Hotel)},
+          {"rentalCars", recordCount(BookingKind::RentalCar)},
+          {"trains", recordCount(BookingKind::Train)},
+          {"total", totalRecords()}}},
+        {"recordsPerSecond", recordsPerSecond()},
+        {"megabytesPerSecond", megabytesPerSecond()},
+        {"allocations", allocations},
+        {"allocatedBytes", allocatedBytes},
+    };
+    return result.dump();
+}
+
+#if TRAVELAGENCY_METRICS
+LoadRecorder::LoadRecorder()
+    : startTime_(std::chrono::steady_clock::now()), startTicks_(ticks()), startAllocations_(allocationCounts()) {}
+
+void LoadRecorder::merge(const LoadRecorder &worker) {
+    for (std::size_t phase = 0; phase < kLoadPhaseCount; ++phase) {
+        phaseTicks_[phase] += worker.phaseTicks_[phase];
+    }
+    bytes_ += worker.bytes_;
+}
+
+void LoadRecorder::finish(LoadMetrics &metrics, const std::array<std::uint64_t, 4> &records) {
+    leave();
+    const AllocationCounts allocations = allocationCounts() - startAllocations_;
+    const std::uint64_t elapsedTicks = ticks() - startTicks_;
+    const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime_).count();
+    // The tick rate is calibrated against the steady clock over the whole load.
+    const double secondsPerTick = elapsedTicks > 0 ? wallSeconds / static_cast<double>(elapsedTicks) : 0.0;
+
+    metrics = LoadMetrics();
+    metrics.wallSeconds = wallSeconds;
+    for (std::size_t phase = 0; phase < kLoadPhaseCount; ++phase) {
+        metrics.phaseSeconds[phase] = static_cast<double>(phaseTicks_[phase]) * secondsPerTick;
+    }
+    metrics.bytesRead = bytes_;
+    metrics.records = records;
+    metrics.allocations = allocations.allocations;
+    metrics.allocatedBytes = allocations.bytes;
+}
+#endif
@@ -0,0 +1,138 @@
+#include "ReportWriter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define REPORTWRITER_USE_FD 1
+#endif
+
+namespace {
+// Longest fixed-notation double with two decimals: sign, 309 integer digits, point and decimals.
+constexpr std::size_t kMaxFixedLength = 320;
+constexpr std::size_t kMaxIntLength = 24;
+// Longest shortest-round-trip double, as "-2.2250738585072014e-308".
+constexpr std::size_t kMaxDoubleLength = 24;
+
+void writeAll(int fd, const char *data, std::size_t size) {
+#ifdef REPORTWRITER_USE_FD
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Could not write report: " + std::string(std::strerror(errno)));
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+#else
+    (void)fd;
+    (void)data;
+    (void)size;
+    throw std::runtime_error("Writing reports to file descriptors is not supported on this platform.");
+#endif
+}
+} // namespace
+
+ReportWriter::ReportWriter(std::ostream &out, std::size_t capacity)
+    : buffer_(std::max(capacity, kMaxFixedLength)), stream_(&out) {}
+
+ReportWriter::ReportWriter(int fd, std::size_t capacity)
+    : buffer_(std::max(capacity, kMaxFixedLength)), fd_(fd) {}
+
+ReportWriter::ReportWriter(std::string &out, std::size_t capacity)
+    : buffer_(std::max(capacity, kMaxFixedLength)), text_(&out) {}
+
+ReportWriter::~ReportWriter() {
+    try {
+        flush();
+    } catch (const std::exception &) {
+    }
+}
+
+void ReportWriter::flush() {
+    if (used_ == 0) {
+        return;
+    }
+    std::size_t size = used_;
+    used_ = 0;
+    writeToSink(buffer_.data(), size);
+}
+
+void ReportWriter::writeToSink(const char *data, std::size_t size) {
+    if (text_ != nullptr) {
+        text_->append(data, size);
+        return;
+    }
+    if (stream_ == nullptr) {
+        writeAll(fd_, data, size);
+        return;
+    }
+    stream_->write(data, static_cast<std::streamsize>(size));
+    stream_->flush();
+    if (!*stream_) {
+        throw std::runtime_error("Could not write report.");
+    }
+}
+
+char *ReportWriter::reserve(std::size_t length) {
+    if (buffer_.size() - used_ < length) {
+        flush();
+    }
+    return buffer_.data() + used_;
+}
+
+ReportWriter &ReportWriter::write(std::string_view text) {
+    if (text.size() > buffer_.size()) {
+        flush();
+        writeToSink(text.data(), text.size());
+        return *this;
+    }
+    char *target = reserve(text.size());
+    std::memcpy(target, text.data(), text.size());
+    used_ += text.size();
+    return *this;
+}
+
+ReportWriter &ReportWriter::write(char ch) {
+    *reserve(1) = ch;
+    ++used_;
+    return *this;
+}
+
+ReportWriter &ReportWriter::writeInt(long long value) {
+    char *target = reserve(kMaxIntLength);
+    used_ = static_cast<std::size_t>(std::to_chars(target, target + kMaxIntLength, value).ptr - buffer_.data());
+    return *this;
+}
+
+ReportWriter &ReportWriter::writeFixed(double value) {
+    char *target = reserve(kMaxFixedLength);
+    auto result = std::to_chars(target, target + kMaxFixedLength, value, std::chars_format::fixed, 2);
+    used_ = static_cast<std::size_t>(result.ptr - buffer_.data());
+    return *this;
+}
+
+ReportWriter &ReportWriter::writeDouble(double value) {
+    char *target = reserve(kMaxDoubleLength);
+    used_ = static_cast<std::size_t>(std::to_chars(target, target + kMaxDoubleLength, value).ptr - buffer_.data());
+    return *this;
+}
+
+ReportWriter &ReportWriter::writeDate(DayNumber date) {
+    ::writeDisplayDate(date, reserve(10));
+    used_ += 10;
+    return *this;
+}
+
+ReportWriter &ReportWriter::writeIsoDate(DayNumber date) {
+    ::writeIsoDate(date, reserve(8));
+    used_ += 8;
+    return *this;
+}
@@ -0,0 +1,120 @@
+#include "SnapshotCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+#include "BinaryBookingWriter.h"
+
+namespace {
+constexpr char kSnapshotMagic[4] = {'B', 'K', 'S', 'N'};
+constexpr std::uint32_t kSnapshotVersion = 1;
+// Magic, version, the source key and the hash of the image that follows.
+constexpr std::size_t kSnapshotHeaderLength =
+    sizeof(kSnapshotMagic) + sizeof(std::uint32_t) + 3 * sizeof(std::uint64_t) + sizeof(std::int64_t);
+
+// 64-bit multiplicative hash over 8-byte words; fast enough to run on every start.
+std::uint64_t hashContent(const char *data, std::size_t size) {
+    constexpr std::uint64_t kMultiplier = 0x9E3779B97F4A7C15ull;
+    std::uint64_t hash = 0xCBF29CE484222325ull ^ size;
+    std::size_t offset = 0;
+    for (; offset + sizeof(std::uint64_t) <= size; offset += sizeof(std::uint64_t)) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, data + offset, sizeof(word));
+        hash = (hash ^ word) * kMultiplier;
+        hash ^= hash >> 29;
+    }
+    std::uint64_t tail = 0;
+    if (offset < size) {
+        std::memcpy(&tail, data + offset, size - offset);
+    }
+    hash = (hash ^ tail) * kMultiplier;
+    return hash ^ (hash >> 32);
+}
+
+template <class T>
+void appendRaw(std::string &header, const T &value) {
+    header.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <class T>
+T loadRaw(const char *data) {
+    T value{};
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+} // namespace
+
+std::string snapshotPath(const std::string &sourcePath) {
+    return sourcePath + ".snapshot";
+}
+
+bool computeSnapshotKey(const std::string &sourcePath, SnapshotKey &key) {
+    std::error_code error;
+    auto modified = std::filesystem::last_write_time(sourcePath, error);
+    if (error) {
+        return false;
+    }
+    MappedFile source;
+    if (!source.open(sourcePath)) {
+        return false;
+    }
+    key.size = source.size();
+    key.modificationTime = static_cast<std::int64_t>(modified.time_since_epoch().count());
+    key.contentHash = hashContent(source.data(), source.size());
+    return true;
+}
+
+bool openSnapshot(const std::string &path, const SnapshotKey &key, MappedFile &image, std::size_t &imageOffset) {
+    if (!image.open(path) || image.size() < kSnapshotHeaderLength ||
+        std::memcmp(image.data(), kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+        return false;
+    }
+    const char *header = image.data() + sizeof(kSnapshotMagic);
+    SnapshotKey stored;
+    if (loadRaw<std::uint32_t>(header) != kSnapshotVersion) {
+        return false;
+    }
+    header += sizeof(std::uint32_t);
+    stored.size = loadRaw<std::uint64_t>(header);
+    stored.modificationTime = loadRaw<std::int64_t>(header + sizeof(std::uint64_t));
+    header += sizeof(std::uint64_t) + sizeof(std::int64_t);
+    stored.contentHash = loadRaw<std::uint64_t>(header);
+    std::uint64_t imageHash = loadRaw<std::uint64_t>(header + sizeof(std::uint64_t));
+    if (!(stored == key) ||
+        hashContent(image.data() + kSnapshotHeaderLength, image.size() - kSnapshotHeaderLength) != imageHash) {
+        return false;
+    }
+    imageOffset = kSnapshotHeaderLength;
+    return true;
+}
+
+void writeSnapshot(const std::string &path, const SnapshotKey &key, const BookingStore &store) {
+    std::ostringstream image(std::ios::binary);
+    writeBinaryBookings(store, image, BinaryFormat::Indexed);
+    const std::string bytes = image.str();
+
+    std::string header(kSnapshotMagic, sizeof(kSnapshotMagic));
+    appendRaw(header, kSnapshotVersion);
+    appendRaw(header, key.size);
+    appendRaw(header, key.modificationTime);
+    appendRaw(header, key.contentHash);
+    appendRaw(header, hashContent(bytes.data(), bytes.size()));
+
+    const std::string temporaryPath = path + ".tmp";
+    std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Could not write snapshot: " + path);
+    }
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    out.close();
+    if (!out || std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        std::remove(temporaryPath.c_str());
+        throw std::runtime_error("Could not write snapshot: " + path);
+    }
+}
@@ -0,0 +1,89 @@
+#include "StationIndex.h"
+
+#include <algorithm>
+#include <limits>
+
+StationIndex::StationId StationIndex::intern(std::string_view station) {
+    auto [it, inserted] = ids_.emplace(station, static_cast<StationId>(names_.size()));
+    if (inserted) {
+        names_.push_back(station);
+        postings_.emplace_back();
+    }
+    return it->second;
+}
+
+void StationIndex::addStop(std::string_view station, std::uint32_t row, std::uint16_t position) {
+    std::vector<Posting> &postings = postings_[intern(station)];
+    if (!postings.empty() && postings.back().row == row) {
+        postings.back().last = position;
+    } else {
+        postings.push_back({row, position, position});
+    }
+}
+
+void StationIndex::add(const TrainTicket &ticket, std::uint32_t row) {
+    const auto &via = ticket.getViaStations();
+    // Positions saturate on absurdly long routes; order among the last stops is then approximate.
+    constexpr std::size_t kMaxPosition = std::numeric_limits<std::uint16_t>::max();
+    std::size_t position = 0;
+    auto next = [&]() { return static_cast<std::uint16_t>(std::min(position++, kMaxPosition)); };
+
+    addStop(ticket.getFromStation(), row, next());
+    for (std::string_view station : via) {
+        addStop(station, row, next());
+    }
+    addStop(ticket.getToStation(), row, next());
+}
+
+void StationIndex::clear() {
+    ids_.clear();
+    names_.clear();
+    postings_.clear();
+}
+
+StationIndex::StationId StationIndex::find(std::string_view station) const {
+    auto it = ids_.find(station);
+    return it == ids_.end() ? kNoStation : it->second;
+}
+
+void StationIndex::passingThrough(std::string_view station, std::vector<std::uint32_t> &rows) const {
+    const StationId id = find(station);
+    if (id == kNoStation) {
+        return;
+    }
+    rows.reserve(rows.size() + postings_[id].size());
+    for (const Posting &posting : postings_[id]) {
+        rows.push_back(posting.row);
+    }
+}
+
+void StationIndex::connecting(std::string_view from, std::string_view to, std::vector<std::uint32_t> &rows) const {
+    const StationId fromId = find(from);
+    const StationId toId = find(to);
+    if (fromId == kNoStation || toId == kNoStation) {
+        return;
+    }
+    const std::vector<Posting> &departures = postings_[fromId];
+    const std::vector<Posting> &arrivals = postings_[toId];
+    auto byRow = [](const Posting &posting, std::uint32_t row) { return posting.row < row; };
+
+    // Walk the shorter list and look each row up in the longer one from the last match on.
+    const bool departuresShorter = departures.size() <= arrivals.size();
+    const std::vector<Posting> &outer = departuresShorter ? departures : arrivals;
+    const std::vector<Posting> &inner = departuresShorter ? arrivals : departures;
+    auto position = inner.begin();
+    for (const Posting &posting : outer) {
+        position = std::lower_bound(position, inner.end(), posting.row, byRow);
+        if (position == inner.end()) {
+            break;
+        }
+        if (position->row != posting.row) {
+            continue;
+        }
+        const Posting &departure = departuresShorter ? posting : *position;
+        const Posting &arrival = departuresShorter ? *position : posting;
+        if (departure.first < arrival.last) {
+            rows.push_back(posting.row);
+        }
+    }
+}
@@ -0,0 +1,258 @@
+#include "StreamingReport.h"
+
+#include "BinaryBookingReader.h"
+#include "BinaryCursor.h"
+#include "BookingArena.h"
+#include "MappedFile.h"
+#include "StringPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+using IdCheck = std::function<void(std::string_view)>;
+using RecordVisitor = std::function<void(const Booking &)>;
+
+// Bookings decoded from an indexed file are released in batches of this many.
+constexpr std::size_t kIndexedReleaseInterval = 4096;
+// No record of either binary format is shorter; bounds the record count of a file by its size.
+constexpr std::size_t kMinRecordLength = 32;
+
+// Reads a file in fixed-size blocks. The next block is read on a background thread while the
+// caller works on the previous one.
+class BlockReader {
+public:
+    BlockReader(const std::string &path, std::size_t blockSize)
+        : in_(path, std::ios::binary), path_(path), blockSize_(std::max<std::size_t>(blockSize, 1)) {
+        if (!in_) {
+            throw std::runtime_error("Could not open binary file: " + path);
+        }
+        startRead();
+    }
+
+    ~BlockReader() {
+        if (pending_.valid()) {
+            pending_.wait();
+        }
+    }
+
+    BlockReader(const BlockReader &) = delete;
+    BlockReader &operator=(const BlockReader &) = delete;
+
+    // Appends the next block to `target`. Returns false once the whole file has been read.
+    bool next(std::vector<char> &target) {
+        const std::size_t length = pending_.get();
+        if (length == 0) {
+            return false;
+        }
+        target.insert(target.end(), spare_.begin(), spare_.begin() + static_cast<std::ptrdiff_t>(length));
+        startRead();
+        return true;
+    }
+
+private:
+    void startRead() {
+        pending_ = std::async(std::launch::async, [this]() {
+            spare_.resize(blockSize_);
+            in_.read(spare_.data(), static_cast<std::streamsize>(blockSize_));
+            if (in_.bad()) {
+                throw std::runtime_error("Could not read binary file: " + path_);
+            }
+            return static_cast<std::size_t>(in_.gcount());
+        });
+    }
+
+    std::ifstream in_;
+    std::string path_;
+    std::size_t blockSize_;
+    std::vector<char> spare_;
+    std::future<std::size_t> pending_;
+};
+
+// Bloom filter over booking ids. It never misses an id added before but may report one that was
+// not, at a rate that depends on how many bits there are per id.
+class IdFilter {
+public:
+    IdFilter(std::size_t maxIds, std::size_t maxBytes) {
+        // Sixteen bits per id keep false positives near 0.05%; more would not pay off.
+        const std::size_t wanted = std::min(maxBytes * 8, std::max<std::size_t>(maxIds, 1) * 16);
+        std::size_t bits = 64;
+        while (bits * 2 <= wanted) {
+            bits *= 2;
+        }
+        words_.assign(bits / 64, 0);
+        mask_ = bits - 1;
+        const double bitsPerId = static_cast<double>(bits) / static_cast<double>(std::max<std::size_t>(maxIds, 1));
+        hashCount_ = static_cast<unsigned>(std::clamp(std::lround(bitsPerId * std::log(2.0)), 1L, 12L));
+    }
+
+    // Adds `id`; returns true if it may have been added before.
+    bool insert(std::string_view id) {
+        const std::uint64_t first = std::hash<std::string_view>{}(id);
+        const std::uint64_t step = mix(first) | 1;
+        bool present = true;
+        for (unsigned i = 0; i < hashCount_; ++i) {
+            const std::uint64_t bit = (first + i * step) & mask_;
+            std::uint64_t &word = words_[bit / 64];
+            const std::uint64_t flag = std::uint64_t{1} << (bit % 64);
+            present = present && (word & flag) != 0;
+            word |= flag;
+        }
+        return present;
+    }
+
+private:
+    // splitmix64 finalizer, to derive a second independent hash.
+    static std::uint64_t mix(std::uint64_t value) {
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+        return value ^ (value >> 31);
+    }
+
+    std::vector<std::uint64_t> words_;
+    std::uint64_t mask_ = 0;
+    unsigned hashCount_ = 1;
+};
+
+// Reads just the first bytes of `path` to tell the indexed format from the fixed-width one.
+bool startsWithIndexedMagic(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Could not open binary file: " + path);
+    }
+    char magic[sizeof(kIndexedBinaryMagic)] = {};
+    in.read(magic, sizeof(magic));
+    return isIndexedBinaryFile(magic, static_cast<std::size_t>(in.gcount()));
+}
+
+void forEachIndexedRecord(const std::string &path, const IdCheck &checkId, const RecordVisitor &visit) {
+    MappedFile file;
+    if (!file.open(path)) {
+        throw std::runtime_error("Could not open binary file: " + path);
+    }
+    IndexedBinaryFile indexed(file.data(), file.size());
+    BookingArena arena;
+    for (std::size_t index = 0; index < indexed.recordCount(); ++index) {
+        // The bookings view the mapped file; nothing but the booking objects needs the arena.
+        visit(*readIndexedBinaryRecord(indexed, index, checkId, arena, nullptr));
+        if ((index + 1) % kIndexedReleaseInterval == 0) {
+            arena.release();
+        }
+    }
+}
+
+// Decodes the records of `path` in file order, passing each to `visit` and dropping it right
+// after. At most two blocks and the bookings of one block are held at a time.
+void forEachBinaryRecord(const std::string &path, std::size_t blockSize, const IdCheck &checkId,
+                         const RecordVisitor &visit) {
+    if (startsWithIndexedMagic(path)) {
+        forEachIndexedRecord(path, checkId, visit);
+        return;
+    }
+
+    std::vector<char> work;
+    BlockReader reader(path, blockSize);
+    bool more = reader.next(work);
+    BookingArena arena;
+    StringPool strings;
+    while (true) {
+        BinaryCursor in(work.data(), work.data() + work.size());
+        while (!in.atEnd()) {
+            // A record cut off by the end of the block is completed by the next one. At the end of
+            // the file it is decoded anyway, so that it fails as in readBinaryFile.
+            if (more && binaryRecordSize(in.position(), in.remaining()) == 0 &&
+                isIncompleteBinaryRecord(in.position(), in.remaining())) {
+                break;
+            }
+            visit(*readBinaryRecord(in, checkId, arena, strings));
+        }
+        if (!more) {
+            return;
+        }
+        work.erase(work.begin(), work.begin() + static_cast<std::ptrdiff_t>(in.offset()));
+        arena.release();
+        strings.clear();
+        more = reader.next(work);
+    }
+}
+
+// Reads the whole file before anything is reported and throws the first error readBinaryFile
+// would throw, be it a repeated id or a malformed record.
+void checkDuplicateIds(const std::string &path, const StreamingReportOptions &options) {
+    std::error_code error;
+    const std::uintmax_t size = std::filesystem::file_size(path, error);
+    IdFilter filter(error ? 0 : static_cast<std::size_t>(size / kMinRecordLength), options.idFilterBytes);
+    // Ids the filter may have seen before, owned by `suspectIds` and keyed by view.
+    std::deque<std::string> suspectIds;
+    std::unordered_map<std::string_view, bool> suspects;
+
+    std::exception_ptr failure;
+    try {
+        forEachBinaryRecord(
+            path, options.blockSize,
+            [&](std::string_view id) {
+                if (filter.insert(id) && suspects.find(id) == suspects.end()) {
+                    suspects.emplace(suspectIds.emplace_back(id), false);
+                }
+            },
+            [](const Booking &) {});
+    } catch (const std::runtime_error &) {
+        failure = std::current_exception();
+    }
+
+    // Only the suspects can be duplicates. Reading the file again in order, the first suspect met
+    // a second time is the duplicate readBinaryFile would have reported, unless a record before it
+    // fails first, which the second pass reproduces as well.
+    if (!suspects.empty()) {
+        forEachBinaryRecord(
+            path, options.blockSize,
+            [&](std::string_view id) {
+                auto it = suspects.find(id);
+                if (it == suspects.end()) {
+                    return;
+                }
+                if (it->second) {
+                    throw std::runtime_error("Duplicate booking id '" + std::string(id) + "' in binary file.");
+                }
+                it->second = true;
+            },
+            [](const Booking &) {});
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+} // namespace
+
+BookingStatistics streamBinaryReport(const std::string &path, ReportWriter &out,
+                                     const StreamingReportOptions &options) {
+    if (options.checkDuplicateIds) {
+        checkDuplicateIds(path, options);
+    }
+
+    BookingStatistics stats;
+    forEachBinaryRecord(
+        path, options.blockSize, [](std::string_view) {},
+        [&](const Booking &booking) {
+            if (options.details) {
+                booking.writeDetails(out);
+            }
+            stats.add(booking.kind(), booking.getPrice());
+        });
+
+    if (options.statistics) {
+        writeStatistics(stats, out);
+    }
+    return stats;
+}
@@ -0,0 +1,71 @@
+#include "StringPool.h"
+
+#include <cstring>
+#include <functional>
+
+namespace {
+constexpr std::size_t kBlockSize = 64 * 1024;
+} // namespace
+
+std::string_view StringPool::Shard::store(std::string_view value) {
+    char *target = nullptr;
+    if (value.size() > kBlockSize / 4) {
+        blocks.push_back(std::make_unique<char[]>(value.size()));
+        target = blocks.back().get();
+    } else {
+        if (available < value.size()) {
+            blocks.push_back(std::make_unique<char[]>(kBlockSize));
+            cursor = blocks.back().get();
+            available = kBlockSize;
+        }
+        target = cursor;
+        cursor += value.size();
+        available -= value.size();
+    }
+    std::memcpy(target, value.data(), value.size());
+    storedBytes += value.size();
+    return {target, value.size()};
+}
+
+std::string_view StringPool::intern(std::string_view value) {
+    if (value.empty()) {
+        return {};
+    }
+
+    Shard &shard = shards_[std::hash<std::string_view>{}(value) % kShardCount];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    ++shard.internedStrings;
+    shard.requestedBytes += value.size();
+    auto it = shard.entries.find(value);
+    if (it != shard.entries.end()) {
+        return *it;
+    }
+    std::string_view stored = shard.store(value);
+    shard.entries.insert(stored);
+    return stored;
+}
+
+void StringPool::clear() {
+    for (auto &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries = {};
+        shard.blocks.clear();
+        shard.cursor = nullptr;
+        shard.available = 0;
+        shard.storedBytes = 0;
+        shard.internedStrings = 0;
+        shard.requestedBytes = 0;
+    }
+}
+
+StringPoolStats StringPool::stats() const {
+    StringPoolStats result;
+    for (const auto &shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        result.uniqueStrings += shard.entries.size();
+        result.storedBytes += shard.storedBytes;
+        result.internedStrings += shard.internedStrings;
+        result.requestedBytes += shard.requestedBytes;
+    }
+    return result;
+}
@@ -1,402 +1,731 @@
 #include "TravelAgency.h"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstdint>
 #include <fstream>
-#include <iomanip>
+#include <iostream>
+#include <iterator>
 #include <limits>
-#include <sstream>
 #include <stdexcept>
 #include <unordered_map>
+#include <unordered_set>
 
-#include "json.hpp"
+#include "BinaryBookingReader.h"
+#include "BinaryBookingWriter.h"
+#include "JsonBookingReader.h"
+#include "MappedFile.h"
+#include "ReportWriter.h"
+#include "SnapshotCache.h"
+#include "ThreadPool.h"
 
 using json = nlohmann::json;
 
-namespace {
-struct ObjectRange {
-    std::size_t start;
-    std::size_t end;
+// A run of consecutive binary records decoded by one worker. Fixed-width chunks are byte ranges;
+// indexed chunks are the records first .. first + recordCount - 1.
+struct BinaryChunk {
+    BinaryChunk(const char *begin, const char *end, std::size_t first, std::size_t recordCount)
+        : begin(begin), end(end), first(first), recordCount(recordCount) {}
+
+    const char *begin;
+    const char *end;
+    std::size_t first;
+    std::size_t recordCount;
+    // Owned by the loading agency; only this chunk's worker allocates from it.
+    BookingArena *arena = nullptr;
+
+    std::vector<BookingPtr> bookings;
+    // First decoding error in this chunk; the records before it are in `bookings`.
+    std::string error;
+    std::string failedId;
+    bool failedAfterId = false;
+    LoadRecorder recorder;
 };
 
-std::vector<ObjectRange> extractTopLevelArrayObjects(const std::string &content) {
-    std::vector<ObjectRange> ranges;
-    bool inString = false;
-    bool escape = false;
-    int arrayDepth = 0;
-    int braceDepth = 0;
-    bool insideObject = false;
-    std::size_t objectStart = 0;
-
-    for (std::size_t i = 0; i < content.size(); ++i) {
-        char ch = content[i];
-        if (escape) {
-            escape = false;
-            continue;
-        }
-        if (ch == '\\') {
-            if (inString) {
-                escape = true;
-            }
-            continue;
-        }
-        if (ch == '"') {
-            inString = !inString;
-            continue;
-        }
-        if (inString) {
-            continue;
-        }
-
-        switch (ch) {
-        case '[':
-            ++arrayDepth;
-            break;
-        case ']':
-            if (arrayDepth > 0) {
-                --arrayDepth;
-                if (arrayDepth == 0) {
-                    braceDepth = 0;
-                    insideObject = false;
-                }
-            }
-            break;
-        case '{':
-            if (arrayDepth == 1 && !insideObject) {
-                insideObject = true;
-                braceDepth = 1;
-                objectStart = i;
-            } else if (insideObject) {
-                ++braceDepth;
-            }
-            break;
-        case '}':
-            if (insideObject) {
-                --braceDepth;
-                if (braceDepth == 0) {
-                    insideObject = false;
-                    ranges.push_back({objectStart, i});
-                }
-            }
-            break;
-        default:
-            break;
-        }
-    }
+namespace {
+// Exports hand the file stream blocks of this size.
+constexpr std::size_t kExportBufferSize = 1024 * 1024;
 
-    return ranges;
+std::string duplicateBinaryIdMessage(std::string_view id) {
+    return "Duplicate booking id '" + std::string(id) + "' in binary file.";
 }
 
-std::size_t computeLineNumber(const std::string &content, std::size_t position) {
-    std::size_t line = 1;
-    for (std::size_t i = 0; i < position && i < content.size(); ++i) {
-        if (content[i] == '\n') {
-            ++line;
-        }
+std::array<std::uint64_t, 4> recordsPerKind(const BookingStatistics &stats) {
+    std::array<std::uint64_t, 4> records{};
+    for (std::size_t kind = 0; kind < records.size(); ++kind) {
+        records[kind] = stats.forKind(static_cast<BookingKind>(kind)).count;
     }
-    return line;
+    return records;
 }
 
-std::string requireString(const json &value, const std::string &key, const std::string &path,
-                          std::size_t lineNumber) {
-    if (!value.contains(key)) {
-        throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Missing attribute '" + key + "'.");
+// Outcome of parsing and validating one bookings array element on a worker thread.
+struct ParsedJsonObject {
+    BookingPtr booking;
+    bool hasId = false;
+    // Validation error, reported after the duplicate check of `failedId` when `hasId` is set.
+    std::string error;
+    std::string failedId;
+    // The element is not valid JSON on its own; the caller reparses sequentially for the exact
+    // diagnostic.
+    bool syntaxError = false;
+};
+
+void parseJsonObject(std::string_view content, const ObjectRange &range, const std::string &path,
+                     BookingArena &arena, StringPool &strings, ParsedJsonObject &result, LoadRecorder &recorder) {
+    json element;
+    recorder.enter(LoadPhase::Parse);
+    try {
+        element = json::parse(content.begin() + range.start, content.begin() + range.end + 1);
+    } catch (const json::exception &) {
+        result.syntaxError = true;
+        return;
     }
-    if (!value[key].is_string()) {
-        throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Attribute '" + key + "' must be a string.");
+    recorder.enter(LoadPhase::Build);
+    try {
+        const std::string &id = requireBookingId(element, path, range.line);
+        result.hasId = true;
+        result.booking = makeBookingFromJson(element, id, path, range.line, arena, strings);
+    } catch (const std::runtime_error &ex) {
+        result.error = ex.what();
+        if (result.hasId) {
+            result.failedId = element.at("id").get<std::string>();
+        }
     }
-    std::string result = value[key].get<std::string>();
-    if (result.empty()) {
-        throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Attribute '" + key + "' must not be empty.");
+}
+
+void decodeBinaryChunk(BinaryChunk &chunk, const IndexedBinaryFile *indexed, StringPool *strings) {
+    chunk.bookings.reserve(chunk.recordCount);
+    bool idRead = false;
+    auto rememberId = [&](std::string_view id) {
+        chunk.failedId = id;
+        idRead = true;
+    };
+    chunk.recorder.enter(LoadPhase::Build);
+    try {
+        if (indexed != nullptr) {
+            for (std::size_t index = chunk.first; index < chunk.first + chunk.recordCount; ++index) {
+                idRead = false;
+                chunk.bookings.push_back(readIndexedBinaryRecord(*indexed, index, rememberId, *chunk.arena, strings));
+            }
+        } else {
+            BinaryCursor in(chunk.begin, chunk.end);
+            while (!in.atEnd()) {
+                idRead = false;
+                chunk.bookings.push_back(readBinaryRecord(in, rememberId, *chunk.arena, *strings));
+            }
+        }
+    } catch (const std::runtime_error &ex) {
+        chunk.error = ex.what();
+        chunk.failedAfterId = idRead;
     }
-    return result;
+    chunk.recorder.leave();
 }
 
-double requirePrice(const json &value, const std::string &path, std::size_t lineNumber) {
-    if (!value.contains("price")) {
-        throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Missing attribute 'price'.");
+void exportFile(const BookingStore &store, const std::string &path, ExportFormat format,
+                const ExportOptions &options) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Could not open export file for writing: " + path);
     }
-    if (!value["price"].is_number()) {
-        throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Attribute 'price' must be numeric.");
+    {
+        ReportWriter writer(out, kExportBufferSize);
+        exportBookings(store, writer, format, options);
+        writer.flush();
     }
-    double price = value["price"].get<double>();
-    if (!std::isfinite(price)) {
-        throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Attribute 'price' must be finite.");
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Could not write export file: " + path);
     }
-    return price;
 }
 
-std::vector<std::string> requireStringArray(const json &value, const std::string &key, const std::string &path,
-                                            std::size_t lineNumber) {
-    if (!value.contains(key)) {
-        throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Missing attribute '" + key + "'.");
-    }
-    if (!value[key].is_array()) {
-        throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Attribute '" + key + "' must be an array.");
-    }
-    std::vector<std::string> result;
-    for (const auto &entry : value[key]) {
-        if (!entry.is_string()) {
-            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Entries in '" + key + "' must be strings.");
-        }
-        result.push_back(entry.get<std::string>());
+std::vector<const TrainTicket *> trainsAt(const BookingStore &store, const std::vector<std::uint32_t> &rows) {
+    std::vector<const TrainTicket *> result;
+    result.reserve(rows.size());
+    for (std::uint32_t row : rows) {
+        result.push_back(&static_cast<const TrainTicket &>(store.booking(row)));
     }
     return result;
 }
-
 } // namespace
 
+TravelAgency::TravelAgency() {
+    arenas_.push_back(std::make_unique<BookingArena>());
+}
+
 TravelAgency::~TravelAgency() {
     clear();
 }
 
-void TravelAgency::addBooking(std::unique_ptr<Booking> booking) {
+void TravelAgency::swap(TravelAgency &other) noexcept {
+    images_.swap(other.images_);
+    arenas_.swap(other.arenas_);
+    bookings_.swap(other.bookings_);
+    idIndex_.swap(other.idIndex_);
+    std::swap(store_, other.store_);
+    std::swap(stats_, other.stats_);
+    std::swap(stations_, other.stations_);
+    tailPath_.swap(other.tailPath_);
+    std::swap(tailOffset_, other.tailOffset_);
+    // The indexes refer to the store they were built over, so they cannot follow it.
+    dropIndexes();
+    other.dropIndexes();
+    strings_.swap(other.strings_);
+    mergedStrings_.swap(other.mergedStrings_);
+}
+
+void TravelAgency::reserve(std::size_t additional) {
+    bookings_.reserve(bookings_.size() + additional);
+    idIndex_.reserve(idIndex_.size() + additional);
+    store_.reserve(store_.size() + additional);
+}
+
+void TravelAgency::adoptArena(std::unique_ptr<BookingArena> arena) {
+    arenas_.push_back(std::move(arena));
+}
+
+void TravelAgency::addBooking(BookingPtr booking) {
+    const auto row = static_cast<std::uint32_t>(bookings_.size());
+    idIndex_.emplace(booking->getId(), row);
+    store_.append(*booking);
+    stats_.add(booking->kind(), booking->getPrice());
+    if (booking->kind() == BookingKind::Train) {
+        stations_.add(static_cast<const TrainTicket &>(*booking), row);
+    }
     bookings_.push_back(std::move(booking));
 }
 
-void TravelAgency::readFile(const std::string &path) {
+void TravelAgency::readFile(const std::string &path, const LoadOptions &options) {
+    LoadRecorder recorder;
+    recorder.enter(LoadPhase::Snapshot);
+    SnapshotKey key;
+    const bool cached = options.useSnapshot && computeSnapshotKey(path, key);
+    if (!cached || !readSnapshot(path, key, options, recorder)) {
+        readJsonFile(path, options, recorder);
+
+        if (cached) {
+            recorder.enter(LoadPhase::Snapshot);
+            try {
+                writeSnapshot(snapshotPath(path), key, store_);
+            } catch (const std::runtime_error &) {
+                // The snapshot only speeds up the next load; an unwritable directory is not an error.
+            }
+        }
+    }
+    recorder.finish(loadMetrics_, recordsPerKind(stats_));
+}
+
+bool TravelAgency::readSnapshot(const std::string &path, const SnapshotKey &key, const LoadOptions &options,
+                                LoadRecorder &recorder) {
+    auto image = std::make_unique<MappedFile>();
+    std::size_t offset = 0;
+    if (!openSnapshot(snapshotPath(path), key, *image, offset)) {
+        return false;
+    }
+    TravelAgency loaded;
+    try {
+        recorder.enter(LoadPhase::Scan);
+        IndexedBinaryFile file(image->data() + offset, image->size() - offset);
+        loaded.readIndexedBinaryRecords(file, options, false, recorder);
+    } catch (const std::runtime_error &) {
+        // A damaged snapshot is rebuilt from the source.
+        return false;
+    }
+    recorder.addBytes(image->size());
+    loaded.images_.push_back(std::move(image));
+    swap(loaded);
+    return true;
+}
+
+void TravelAgency::readJsonFile(const std::string &path, const LoadOptions &options, LoadRecorder &recorder) {
+    if (options.parallel) {
+        recorder.enter(LoadPhase::Open);
+        MappedFile file;
+        if (!file.open(path)) {
+            throw std::runtime_error("Could not open JSON file: " + path);
+        }
+        TravelAgency loaded;
+        if (loaded.readJsonObjectsParallel(std::string_view(file.data(), file.size()), path, options, recorder)) {
+            recorder.addBytes(file.size());
+            swap(loaded);
+            return;
+        }
+    }
+
+    recorder.enter(LoadPhase::Open);
     std::ifstream in(path);
     if (!in) {
         throw std::runtime_error("Could not open JSON file: " + path);
     }
+    in.seekg(0, std::ios::end);
+    const std::streamoff size = in.tellg();
+    in.seekg(0, std::ios::beg);
+
+    // Bookings are staged in a separate agency so that a malformed file leaves the current data intact.
+    TravelAgency loaded;
+    recorder.enter(LoadPhase::Parse);
+    readJsonBookingStream(in, path, [&](const json &element, std::size_t lineNumber) {
+        recorder.enter(LoadPhase::Build);
+        const std::string &id = requireBookingId(element, path, lineNumber);
+        recorder.enter(LoadPhase::DuplicateCheck);
+        if (loaded.existsId(id)) {
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Duplicate booking id '" + id + "'.");
+        }
+        recorder.enter(LoadPhase::Build);
+        BookingPtr booking = makeBookingFromJson(element, id, path, lineNumber, loaded.arena(), *loaded.strings_);
+        recorder.enter(LoadPhase::Insert);
+        loaded.addBooking(std::move(booking));
+        recorder.enter(LoadPhase::Parse);
+    });
+    if (size > 0) {
+        recorder.addBytes(static_cast<std::uint64_t>(size));
+    }
 
-    std::ostringstream buffer;
-    buffer << in.rdbuf();
-    const std::string content = buffer.str();
+    swap(loaded);
+}
 
-    json root;
-    try {
-        root = json::parse(content);
-    } catch (const json::parse_error &ex) {
-        throw std::runtime_error(path + ":" + std::to_string(ex.byte) + ": JSON parse error: " + std::string(ex.what()));
+bool TravelAgency::readJsonObjectsParallel(std::string_view content, const std::string &path,
+                                           const LoadOptions &options, LoadRecorder &recorder) {
+    std::vector<ObjectRange> ranges;
+    recorder.enter(LoadPhase::Scan);
+    if (!extractTopLevelArrayObjects(content, ranges)) {
+        return false;
     }
 
-    const json *bookingsNode = nullptr;
-    if (root.is_array()) {
-        bookingsNode = &root;
-    } else if (root.is_object() && root.contains("bookings")) {
-        bookingsNode = &root["bookings"];
+    const std::size_t threadCount = options.threadCount > 0 ? options.threadCount : ThreadPool::defaultThreadCount();
+    const std::size_t batchCount = std::min(ranges.size(), threadCount * 4);
+    // Each batch allocates from its own arena, owned by this agency so that it outlives the results.
+    const std::size_t firstArena = arenas_.size();
+    for (std::size_t batch = 0; batch < batchCount; ++batch) {
+        adoptArena(std::make_unique<BookingArena>());
+    }
+    std::vector<ParsedJsonObject> results(ranges.size());
+    std::vector<LoadRecorder> batchRecorders(batchCount);
+    // Declared after the storage its tasks write to, so that an exception unwinding this frame
+    // finishes and joins the workers before that storage is destroyed.
+    ThreadPool pool(threadCount);
+    std::vector<std::future<void>> pending;
+    pending.reserve(batchCount);
+    recorder.leave();
+    for (std::size_t batch = 0; batch < batchCount; ++batch) {
+        std::size_t first = ranges.size() * batch / batchCount;
+        std::size_t last = ranges.size() * (batch + 1) / batchCount;
+        pending.push_back(pool.submit([&, batch, first, last]() {
+            LoadRecorder &batchRecorder = batchRecorders[batch];
+            for (std::size_t index = first; index < last; ++index) {
+                parseJsonObject(content, ranges[index], path, *arenas_[firstArena + batch], *strings_, results[index],
+                                batchRecorder);
+            }
+            batchRecorder.leave();
+        }));
+    }
+    for (auto &task : pending) {
+        task.get();
+    }
+    for (const LoadRecorder &batchRecorder : batchRecorders) {
+        recorder.merge(batchRecorder);
     }
 
-    if (!bookingsNode || !bookingsNode->is_array()) {
-        throw std::runtime_error(path + ":1: JSON must contain an array of bookings.");
+    // Merge in file order: the first failing record by position decides the reported error.
+    reserve(ranges.size());
+    for (std::size_t index = 0; index < results.size(); ++index) {
+        auto &result = results[index];
+        if (result.syntaxError) {
+            return false;
+        }
+        std::string_view id = result.booking ? result.booking->getId() : std::string_view(result.failedId);
+        recorder.enter(LoadPhase::DuplicateCheck);
+        if (result.hasId && existsId(id)) {
+            throw std::runtime_error(path + ":" + std::to_string(ranges[index].line) + ": Duplicate booking id '" +
+                                     std::string(id) + "'.");
+        }
+        if (!result.error.empty()) {
+            throw std::runtime_error(result.error);
+        }
+        recorder.enter(LoadPhase::Insert);
+        addBooking(std::move(result.booking));
     }
+    recorder.leave();
+    return true;
+}
 
-    auto ranges = extractTopLevelArrayObjects(content);
-    if (ranges.size() != bookingsNode->size()) {
-        ranges.resize(bookingsNode->size());
+void TravelAgency::readBinaryFile(const std::string &path, const LoadOptions &options) {
+    LoadRecorder recorder;
+    recorder.enter(LoadPhase::Open);
+    MappedFile file;
+    if (!file.open(path)) {
+        throw std::runtime_error("Could not open binary file: " + path);
+    }
+    recorder.addBytes(file.size());
+
+    TravelAgency loaded;
+    if (isIndexedBinaryFile(file.data(), file.size())) {
+        recorder.enter(LoadPhase::Scan);
+        loaded.readIndexedBinaryRecords(IndexedBinaryFile(file.data(), file.size()), options, true, recorder);
+    } else {
+        BinaryCursor in(file.data(), file.data() + file.size());
+        if (options.parallel) {
+            loaded.readBinaryRecordsParallel(in, options, recorder);
+        }
+        loaded.readBinaryRecords(in, recorder);
+        loaded.tailPath_ = path;
+        loaded.tailOffset_ = file.size();
     }
 
-    clear();
+    swap(loaded);
+    recorder.finish(loadMetrics_, recordsPerKind(stats_));
+}
 
-    for (std::size_t index = 0; index < bookingsNode->size(); ++index) {
-        const auto &bookingNode = (*bookingsNode)[index];
-        std::size_t lineNumber = ranges.empty() ? 1 : computeLineNumber(content, ranges[index].start);
+std::size_t TravelAgency::appendBinaryFile(const std::string &path) {
+    LoadRecorder recorder;
+    recorder.enter(LoadPhase::Open);
+    MappedFile file;
+    if (!file.open(path)) {
+        throw std::runtime_error("Could not open binary file: " + path);
+    }
+    const std::uint64_t offset = path == tailPath_ ? tailOffset_ : 0;
+    if (file.size() < offset) {
+        throw std::runtime_error("Binary file is shorter than the part already read: " + path);
+    }
+    if (offset == 0 && isIndexedBinaryFile(file.data(), file.size())) {
+        throw std::runtime_error("Only fixed-width binary files can be appended to: " + path);
+    }
 
-        if (!bookingNode.is_object()) {
-            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Booking entry must be an object.");
+    // Decode everything first so that a failing record leaves the loaded bookings untouched.
+    auto appendArena = std::make_unique<BookingArena>();
+    std::vector<BookingPtr> added;
+    std::unordered_set<std::string_view> addedIds;
+    auto rejectDuplicate = [this, &addedIds, &recorder](std::string_view id) {
+        recorder.enter(LoadPhase::DuplicateCheck);
+        if (existsId(id) || !addedIds.insert(id).second) {
+            throw std::runtime_error(duplicateBinaryIdMessage(id));
         }
-
-        std::string id = requireString(bookingNode, "id", path, lineNumber);
-        if (existsId(id)) {
-            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Duplicate booking id '" + id + "'.");
+        recorder.enter(LoadPhase::Build);
+    };
+    BinaryCursor in(file.data() + offset, file.data() + file.size());
+    std::array<std::uint64_t, 4> records{};
+    while (!in.atEnd()) {
+        recorder.enter(LoadPhase::Scan);
+        if (binaryRecordSize(in.position(), in.remaining()) == 0 &&
+            isIncompleteBinaryRecord(in.position(), in.remaining())) {
+            break;
         }
+        recorder.enter(LoadPhase::Build);
+        added.push_back(readBinaryRecord(in, rejectDuplicate, *appendArena, *strings_));
+        ++records[static_cast<std::size_t>(added.back()->kind())];
+    }
 
-        std::string type = requireString(bookingNode, "type", path, lineNumber);
-        double price = requirePrice(bookingNode, path, lineNumber);
-        std::string fromDate = requireString(bookingNode, "fromDate", path, lineNumber);
-        std::string toDate = requireString(bookingNode, "toDate", path, lineNumber);
+    recorder.enter(LoadPhase::Insert);
+    reserve(added.size());
+    for (BookingPtr &booking : added) {
+        addBooking(std::move(booking));
+    }
+    adoptArena(std::move(appendArena));
+    if (indexes_) {
+        indexes_->extend();
+    }
+    tailPath_ = path;
+    tailOffset_ = offset + in.offset();
+    recorder.addBytes(in.offset());
+    recorder.finish(loadMetrics_, records);
+    return added.size();
+}
 
-        if (type == "Flight") {
-            std::string fromAirport = requireString(bookingNode, "fromAirport", path, lineNumber);
-            std::string toAirport = requireString(bookingNode, "toAirport", path, lineNumber);
-            if (!isAirportCode(fromAirport) || !isAirportCode(toAirport)) {
-                throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Airport codes must have exactly three alphabetic characters.");
-            }
-            std::string airline = requireString(bookingNode, "airline", path, lineNumber);
-            addBooking(std::make_unique<FlightBooking>(id, price, fromDate, toDate, fromAirport, toAirport, airline));
-        } else if (type == "Hotel") {
-            std::string hotel = requireString(bookingNode, "hotel", path, lineNumber);
-            std::string city = requireString(bookingNode, "city", path, lineNumber);
-            addBooking(std::make_unique<HotelReservation>(id, price, fromDate, toDate, hotel, city));
-        } else if (type == "RentalCar") {
-            std::string pickup = requireString(bookingNode, "pickupLocation", path, lineNumber);
-            std::string dropoff = requireString(bookingNode, "returnLocation", path, lineNumber);
-            std::string company = requireString(bookingNode, "company", path, lineNumber);
-            addBooking(std::make_unique<RentalCarReservation>(id, price, fromDate, toDate, pickup, dropoff, company));
-        } else if (type == "Train") {
-            std::string fromStation = requireString(bookingNode, "fromStation", path, lineNumber);
-            std::string toStation = requireString(bookingNode, "toStation", path, lineNumber);
-            std::string departure = requireString(bookingNode, "departureTime", path, lineNumber);
-            std::string arrival = requireString(bookingNode, "arrivalTime", path, lineNumber);
-            auto viaStations = bookingNode.contains("viaStations")
-                                   ? requireStringArray(bookingNode, "viaStations", path, lineNumber)
-                                   : std::vector<std::string>{};
-            addBooking(std::make_unique<TrainTicket>(id, price, fromDate, toDate, fromStation, toStation, departure,
-                                                     arrival, viaStations));
-        } else {
-            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": Unknown booking type '" + type + "'.");
+void TravelAgency::merge(TravelAgency &other) {
+    for (const BookingPtr &booking : other.bookings_) {
+        if (existsId(booking->getId())) {
+            throw std::runtime_error("Duplicate booking id '" + std::string(booking->getId()) + "'.");
         }
     }
+
+    reserve(other.bookings_.size());
+    for (BookingPtr &booking : other.bookings_) {
+        addBooking(std::move(booking));
+    }
+    for (auto &arena : other.arenas_) {
+        adoptArena(std::move(arena));
+    }
+    std::move(other.images_.begin(), other.images_.end(), std::back_inserter(images_));
+    mergedStrings_.push_back(std::move(other.strings_));
+    std::move(other.mergedStrings_.begin(), other.mergedStrings_.end(), std::back_inserter(mergedStrings_));
+    if (indexes_) {
+        indexes_->extend();
+    }
+
+    // Everything `other` owned has moved; start it over with fresh storage.
+    other.arenas_.clear();
+    other.arenas_.push_back(std::make_unique<BookingArena>());
+    other.images_.clear();
+    other.mergedStrings_.clear();
+    other.strings_ = std::make_unique<StringPool>();
+    other.clear();
 }
 
-void TravelAgency::readBinaryFile(const std::string &path) {
-    std::ifstream in(path, std::ios::binary);
-    if (!in) {
-        throw std::runtime_error("Could not open binary file: " + path);
+void TravelAgency::writeBinaryFile(const std::string &path, BinaryFormat format) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Could not open binary file for writing: " + path);
+    }
+    writeBinaryBookings(store_, out, format);
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Could not write binary file: " + path);
     }
+}
 
-    clear();
+void TravelAgency::writeJsonFile(const std::string &path, const ExportOptions &options) const {
+    validateJsonExport(store_);
+    exportFile(store_, path, ExportFormat::Json, options);
+}
+
+void TravelAgency::writeCsvFile(const std::string &path, const ExportOptions &options) const {
+    exportFile(store_, path, ExportFormat::Csv, options);
+}
 
-    auto readFixedString = [](std::ifstream &stream, std::size_t length) {
-        std::string value(length, '\0');
-        stream.read(value.data(), static_cast<std::streamsize>(length));
-        if (!stream) {
-            throw std::runtime_error("Unexpected end of file while reading binary data.");
+void TravelAgency::readBinaryRecords(BinaryCursor &in, LoadRecorder &recorder) {
+    auto rejectDuplicate = [this, &recorder](std::string_view id) {
+        recorder.enter(LoadPhase::DuplicateCheck);
+        if (existsId(id)) {
+            throw std::runtime_error(duplicateBinaryIdMessage(id));
         }
-        return trimSpaces(value);
+        recorder.enter(LoadPhase::Build);
     };
+    while (!in.atEnd()) {
+        recorder.enter(LoadPhase::Build);
+        BookingPtr booking = readBinaryRecord(in, rejectDuplicate, arena(), *strings_);
+        recorder.enter(LoadPhase::Insert);
+        addBooking(std::move(booking));
+    }
+    recorder.leave();
+}
 
-    auto readDouble = [](std::ifstream &stream) {
-        double value = 0.0;
-        stream.read(reinterpret_cast<char *>(&value), sizeof(double));
-        if (!stream) {
-            throw std::runtime_error("Unexpected end of file while reading binary data.");
+void TravelAgency::readIndexedBinaryRecords(const IndexedBinaryFile &file, const LoadOptions &options,
+                                            bool copyText, LoadRecorder &recorder) {
+    StringPool *strings = copyText ? strings_.get() : nullptr;
+    const std::size_t count = file.recordCount();
+    if (options.parallel && count > 0) {
+        const std::size_t threadCount =
+            options.threadCount > 0 ? options.threadCount : ThreadPool::defaultThreadCount();
+        const std::size_t chunkCount = std::clamp<std::size_t>(count / 16384, 1, threadCount * 4);
+        std::vector<BinaryChunk> chunks;
+        chunks.reserve(chunkCount);
+        for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            std::size_t first = count * chunk / chunkCount;
+            std::size_t last = count * (chunk + 1) / chunkCount;
+            chunks.emplace_back(nullptr, nullptr, first, last - first);
         }
-        return value;
-    };
+        // Declared after the chunks its tasks decode into, so that it is joined before they go.
+        ThreadPool pool(threadCount);
+        decodeBinaryChunks(chunks, &file, strings, pool, recorder);
+        return;
+    }
 
-    auto readInt32 = [](std::ifstream &stream) {
-        std::int32_t value = 0;
-        stream.read(reinterpret_cast<char *>(&value), sizeof(std::int32_t));
-        if (!stream) {
-            throw std::runtime_error("Unexpected end of file while reading binary data.");
+    auto rejectDuplicate = [this, &recorder](std::string_view id) {
+        recorder.enter(LoadPhase::DuplicateCheck);
+        if (existsId(id)) {
+            throw std::runtime_error(duplicateBinaryIdMessage(id));
         }
-        return value;
+        recorder.enter(LoadPhase::Build);
     };
+    reserve(count);
+    for (std::size_t index = 0; index < count; ++index) {
+        recorder.enter(LoadPhase::Build);
+        BookingPtr booking = readIndexedBinaryRecord(file, index, rejectDuplicate, arena(), strings);
+        recorder.enter(LoadPhase::Insert);
+        addBooking(std::move(booking));
+    }
+    recorder.leave();
+}
 
-    while (in.peek() != EOF) {
-        char type = '\0';
-        in.read(&type, sizeof(char));
-        if (!in) {
+void TravelAgency::readBinaryRecordsParallel(BinaryCursor &in, const LoadOptions &options, LoadRecorder &recorder) {
+    const std::size_t threadCount = options.threadCount > 0 ? options.threadCount : ThreadPool::defaultThreadCount();
+    recorder.enter(LoadPhase::Scan);
+
+    // Split the well-formed prefix of the file into chunks of whole records. Decoding stops at the
+    // first record the scan cannot size; the sequential reader picks up from there and reports
+    // the exact error.
+    const char *data = in.position();
+    const std::size_t available = in.remaining();
+    const std::size_t chunkTarget = std::max<std::size_t>(1 << 20, available / (threadCount * 4) + 1);
+
+    std::vector<BinaryChunk> chunks;
+    std::size_t offset = 0;
+    std::size_t chunkStart = 0;
+    std::size_t chunkRecords = 0;
+    while (offset < available) {
+        std::size_t size = binaryRecordSize(data + offset, available - offset);
+        if (size == 0) {
             break;
         }
-
-        std::string id = readFixedString(in, 38);
-        if (id.empty()) {
-            throw std::runtime_error("Binary record contains empty id.");
-        }
-        if (existsId(id)) {
-            throw std::runtime_error("Duplicate booking id '" + id + "' in binary file.");
+        offset += size;
+        ++chunkRecords;
+        if (offset - chunkStart >= chunkTarget) {
+            chunks.emplace_back(data + chunkStart, data + offset, 0, chunkRecords);
+            chunkStart = offset;
+            chunkRecords = 0;
         }
+    }
+    if (chunkRecords > 0) {
+        chunks.emplace_back(data + chunkStart, data + offset, 0, chunkRecords);
+    }
+    // Declared after the chunks its tasks decode into, so that it is joined before they go.
+    ThreadPool pool(threadCount);
+    decodeBinaryChunks(chunks, nullptr, strings_.get(), pool, recorder);
 
-        double price = readDouble(in);
-        if (!std::isfinite(price)) {
-            throw std::runtime_error("Binary record contains invalid price value.");
-        }
+    in.skip(offset);
+}
 
-        std::string fromDate = readFixedString(in, 8);
-        std::string toDate = readFixedString(in, 8);
+void TravelAgency::decodeBinaryChunks(std::vector<BinaryChunk> &chunks, const IndexedBinaryFile *indexed,
+                                      StringPool *strings, ThreadPool &pool, LoadRecorder &recorder) {
+    std::size_t totalRecords = 0;
+    for (auto &chunk : chunks) {
+        auto arena = std::make_unique<BookingArena>();
+        chunk.arena = arena.get();
+        adoptArena(std::move(arena));
+        totalRecords += chunk.recordCount;
+    }
 
-        switch (type) {
-        case 'F': {
-            std::string fromAirport = readFixedString(in, 3);
-            std::string toAirport = readFixedString(in, 3);
-            std::string airline = readFixedString(in, 15);
-            addBooking(std::make_unique<FlightBooking>(id, price, fromDate, toDate, fromAirport, toAirport, airline));
-            break;
-        }
-        case 'H': {
-            std::string hotel = readFixedString(in, 15);
-            std::string city = readFixedString(in, 15);
-            addBooking(std::make_unique<HotelReservation>(id, price, fromDate, toDate, hotel, city));
-            break;
-        }
-        case 'R': {
-            std::string pickup = readFixedString(in, 15);
-            std::string dropoff = readFixedString(in, 15);
-            std::string company = readFixedString(in, 15);
-            addBooking(std::make_unique<RentalCarReservation>(id, price, fromDate, toDate, pickup, dropoff, company));
-            break;
-        }
-        case 'T': {
-            std::string fromStation = readFixedString(in, 15);
-            std::string toStation = readFixedString(in, 15);
-            std::string departure = readFixedString(in, 5);
-            std::string arrival = readFixedString(in, 5);
-            std::int32_t countVia = readInt32(in);
-            if (countVia < 0) {
-                throw std::runtime_error("Binary record contains negative via station count.");
-            }
-            std::vector<std::string> viaStations;
-            viaStations.reserve(static_cast<std::size_t>(countVia));
-            for (std::int32_t i = 0; i < countVia; ++i) {
-                viaStations.push_back(readFixedString(in, 15));
+    std::vector<std::future<void>> pending;
+    pending.reserve(chunks.size());
+    for (auto &chunk : chunks) {
+        pending.push_back(pool.submit([&chunk, indexed, strings]() { decodeBinaryChunk(chunk, indexed, strings); }));
+    }
+    recorder.leave();
+    for (auto &task : pending) {
+        task.get();
+    }
+    for (const auto &chunk : chunks) {
+        recorder.merge(chunk.recorder);
+    }
+
+    // Merge in file order so that duplicate ids and decoding errors surface exactly where the
+    // sequential reader would report them.
+    reserve(totalRecords);
+    for (auto &chunk : chunks) {
+        for (auto &booking : chunk.bookings) {
+            recorder.enter(LoadPhase::DuplicateCheck);
+            if (existsId(booking->getId())) {
+                throw std::runtime_error(duplicateBinaryIdMessage(booking->getId()));
             }
-            addBooking(std::make_unique<TrainTicket>(id, price, fromDate, toDate, fromStation, toStation, departure,
-                                                     arrival, viaStations));
-            break;
+            recorder.enter(LoadPhase::Insert);
+            addBooking(std::move(booking));
         }
-        default:
-            throw std::runtime_error("Unknown record type in binary file: " + std::string(1, type));
+        if (!chunk.error.empty()) {
+            if (chunk.failedAfterId && existsId(chunk.failedId)) {
+                throw std::runtime_error(duplicateBinaryIdMessage(chunk.failedId));
+            }
+            throw std::runtime_error(chunk.error);
         }
     }
+    recorder.leave();
 }
 
 void TravelAgency::printAllDetails() const {
+    ReportWriter out(std::cout);
+    printAllDetails(out);
+}
+
+void TravelAgency::printAllDetails(ReportWriter &out) const {
     for (const auto &booking : bookings_) {
-        booking->showDetails();
+        booking->writeDetails(out);
     }
 }
 
 void TravelAgency::printStatistics() const {
-    struct Stats {
-        int count = 0;
-        double sum = 0.0;
-    };
-
-    Stats flights;
-    Stats rentals;
-    Stats hotels;
-    Stats trains;
+    ReportWriter out(std::cout);
+    printStatistics(out);
+}
 
-    for (const auto &booking : bookings_) {
-        if (dynamic_cast<const FlightBooking *>(booking.get())) {
-            ++flights.count;
-            flights.sum += booking->getPrice();
-        } else if (dynamic_cast<const RentalCarReservation *>(booking.get())) {
-            ++rentals.count;
-            rentals.sum += booking->getPrice();
-        } else if (dynamic_cast<const HotelReservation *>(booking.get())) {
-            ++hotels.count;
-            hotels.sum += booking->getPrice();
-        } else if (dynamic_cast<const TrainTicket *>(booking.get())) {
-            ++trains.count;
-            trains.sum += booking->getPrice();
-        }
-    }
+void TravelAgency::printStatistics(ReportWriter &out) const {
+    writeStatistics(stats_, out);
+}
 
-    auto formatStats = [](const Stats &stats) {
-        std::ostringstream oss;
-        oss << stats.count << " (" << std::fixed << std::setprecision(2) << stats.sum << " Euro)";
-        return oss.str();
-    };
+void TravelAgency::printGroupReport(GroupBy groupBy) const {
+    ReportWriter out(std::cout);
+    printGroupReport(groupBy, out);
+}
 
-    std::cout << "Flights: " << formatStats(flights) << ", "
-              << "RentalCars: " << formatStats(rentals) << ", "
-              << "Hotels: " << formatStats(hotels) << ", "
-              << "Trains: " << formatStats(trains) << '\n';
+void TravelAgency::printGroupReport(GroupBy groupBy, ReportWriter &out) const {
+    for (const GroupTotal &group : groupTotals(groupBy)) {
+        out.write(group.key).write(": ").writeInt(static_cast<long long>(group.count)).write(" (");
+        out.writeFixed(group.revenue).write(" Euro)\n");
+    }
 }
 
 void TravelAgency::clear() {
+    idIndex_.clear();
+    store_.clear();
+    stats_.clear();
+    stations_.clear();
+    dropIndexes();
+    tailPath_.clear();
+    tailOffset_ = 0;
     bookings_.clear();
+    images_.clear();
+    arenas_.resize(1);
+    arena().release();
+    strings_->clear();
+    mergedStrings_.clear();
 }
 
-bool TravelAgency::existsId(const std::string &id) const {
-    for (const auto &booking : bookings_) {
-        if (booking->getId() == id) {
-            return true;
-        }
+bool TravelAgency::existsId(std::string_view id) const {
+    return idIndex_.find(id) != idIndex_.end();
+}
+
+const Booking *TravelAgency::findById(std::string_view id) const {
+    auto it = idIndex_.find(id);
+    if (it == idIndex_.end()) {
+        return nullptr;
+    }
+    return bookings_[it->second].get();
+}
+
+const BookingIndexes &TravelAgency::indexes() const {
+    if (const BookingIndexes *built = builtIndexes_.load(std::memory_order_acquire)) {
+        return *built;
     }
-    return false;
+    std::lock_guard<std::mutex> lock(indexesMutex_);
+    if (!indexes_) {
+        indexes_ = std::make_unique<BookingIndexes>(store_);
+        builtIndexes_.store(indexes_.get(), std::memory_order_release);
+    }
+    return *indexes_;
+}
+
+void TravelAgency::dropIndexes() {
+    builtIndexes_.store(nullptr, std::memory_order_relaxed);
+    indexes_.reset();
+}
+
+std::vector<const Booking *> TravelAgency::findOverlapping(DayNumber from, DayNumber to) const {
+    std::vector<std::uint32_t> rows;
+    indexes().findOverlapping(from, to, rows);
+    std::vector<const Booking *> result;
+    result.reserve(rows.size());
+    for (std::uint32_t row : rows) {
+        result.push_back(&store_.booking(row));
+    }
+    return result;
+}
+
+std::vector<const Booking *> TravelAgency::findBookings(const BookingQuery &query) const {
+    const std::vector<std::uint32_t> rows = indexes().find(query);
+    std::vector<const Booking *> result;
+    result.reserve(rows.size());
+    for (std::uint32_t row : rows) {
+        result.push_back(&store_.booking(row));
+    }
+    return result;
+}
+
+std::vector<const TrainTicket *> TravelAgency::findTrainsThrough(std::string_view station) const {
+    std::vector<std::uint32_t> rows;
+    stations_.passingThrough(station, rows);
+    return trainsAt(store_, rows);
+}
+
+std::vector<const TrainTicket *> TravelAgency::findTrainConnections(std::string_view from, std::string_view to) const {
+    std::vector<std::uint32_t> rows;
+    stations_.connecting(from, to, rows);
+    return trainsAt(store_, rows);
 }
@@ -1,10 +1,294 @@
+#include "StreamingReport.h"
+#include "ThreadPool.h"
 #include "TravelAgency.h"
 
+#include "json.hpp"
+
+#include <algorithm>
+#include <future>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <string>
+#include <vector>
+
+namespace {
+// Files ending in ".json" are read as JSON, everything else as binary.
+void loadFile(TravelAgency &agency, const std::string &path, const LoadOptions &options) {
+    if (path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0) {
+        agency.readFile(path, options);
+    } else {
+        agency.readBinaryFile(path, options);
+    }
+}
+
+// TravelAgency --convert <input.json> <output.bin> [--fixed-width]
+int convertJsonToBinary(int argc, char *argv[]) {
+    const bool fixedWidth = argc == 5 && std::string(argv[4]) == "--fixed-width";
+    if (argc != 4 && !fixedWidth) {
+        std::cerr << "Verwendung: " << argv[0] << " --convert <eingabe.json> <ausgabe.bin> [--fixed-width]\n";
+        return 2;
+    }
+    try {
+        TravelAgency agency;
+        agency.readFile(argv[2]);
+        agency.writeBinaryFile(argv[3], fixedWidth ? BinaryFormat::FixedWidth : BinaryFormat::Indexed);
+        std::cout << agency.size() << " Buchungen nach " << argv[3] << " geschrieben.\n";
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+// TravelAgency --export <json|csv> <eingabe> <ausgabe> [--parallel]
+int exportBookingsTo(int argc, char *argv[]) {
+    const bool parallel = argc == 6 && std::string(argv[5]) == "--parallel";
+    const std::string format = argc > 2 ? argv[2] : "";
+    if ((argc != 5 && !parallel) || (format != "json" && format != "csv")) {
+        std::cerr << "Verwendung: " << argv[0] << " --export <json|csv> <eingabe> <ausgabe> [--parallel]\n";
+        return 2;
+    }
+    try {
+        TravelAgency agency;
+        LoadOptions loadOptions;
+        loadOptions.parallel = parallel;
+        loadFile(agency, argv[3], loadOptions);
+        ExportOptions exportOptions;
+        exportOptions.parallel = parallel;
+        if (format == "json") {
+            agency.writeJsonFile(argv[4], exportOptions);
+        } else {
+            agency.writeCsvFile(argv[4], exportOptions);
+        }
+        std::cout << agency.size() << " Buchungen nach " << argv[4] << " exportiert.\n";
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+// TravelAgency --group-by <airline|city|company|route|month> <datei>
+int printGroupReport(int argc, char *argv[]) {
+    GroupBy groupBy;
+    if (argc != 4 || !parseGroupBy(argv[2], groupBy)) {
+        std::cerr << "Verwendung: " << argv[0] << " --group-by <airline|city|company|route|month> <datei>\n";
+        return 2;
+    }
+    const std::string path = argv[3];
+    try {
+        TravelAgency agency;
+        LoadOptions options;
+        options.parallel = true;
+        loadFile(agency, path, options);
+        agency.printGroupReport(groupBy);
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+// TravelAgency --metrics [--parallel] <datei>
+int printLoadMetrics(int argc, char *argv[]) {
+    const bool parallel = argc == 4 && std::string(argv[2]) == "--parallel";
+    if (argc != 3 && !parallel) {
+        std::cerr << "Verwendung: " << argv[0] << " --metrics [--parallel] <datei>\n";
+        return 2;
+    }
+    try {
+        TravelAgency agency;
+        LoadOptions options;
+        options.parallel = parallel;
+        loadFile(agency, argv[argc - 1], options);
+        std::cout << agency.loadMetrics().toJson() << "\n";
+    } catch (const std::exception &ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+// Parses the value of --threads: a whole number from 1 to 1024. Returns 0 for anything else.
+std::size_t parseThreadCount(const std::string &text) {
+    constexpr unsigned long long kMaxThreads = 1024;
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos || text.size() > 4) {
+        return 0;
+    }
+    const unsigned long long count = std::stoull(text);
+    return count <= kMaxThreads ? static_cast<std::size_t>(count) : 0;
+}
+
+int batchUsage(const char *program) {
+    std::cerr << "Verwendung: " << program
+              << " --batch [--details] [--statistics] [--metrics] [--threads N] <datei>...\n";
+    return 2;
+}
+
+// TravelAgency --batch [--details] [--statistics] [--metrics] [--threads N] <datei>...
+// Loads all files concurrently and merges them in argument order into one agency; an id that
+// occurs in two files is an error. Without an output option only the statistics are printed.
+int runBatch(int argc, char *argv[]) {
+    bool details = false;
+    bool statistics = false;
+    bool metrics = false;
+    std::size_t threadCount = 0;
+    std::vector<std::string> paths;
+    for (int i = 2; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (argument == "--details") {
+            details = true;
+        } else if (argument == "--statistics") {
+            statistics = true;
+        } else if (argument == "--metrics") {
+            metrics = true;
+        } else if (argument == "--threads" && i + 1 < argc) {
+            threadCount = parseThreadCount(argv[++i]);
+            if (threadCount == 0) {
+                return batchUsage(argv[0]);
+            }
+        } else if (argument.compare(0, 2, "--") == 0) {
+            return batchUsage(argv[0]);
+        } else {
+            paths.push_back(argument);
+        }
+    }
+    if (paths.empty()) {
+        return batchUsage(argv[0]);
+    }
+    if (!details && !statistics && !metrics) {
+        statistics = true;
+    }
+
+    // A single file is decoded on all threads; several files are loaded side by side, one per
+    // thread, so that the pools do not compete.
+    LoadOptions options;
+    options.parallel = paths.size() == 1;
+    options.threadCount = threadCount;
+    std::vector<std::unique_ptr<TravelAgency>> loaded(paths.size());
+    {
+        const std::size_t workers = threadCount > 0 ? threadCount : ThreadPool::defaultThreadCount();
+        ThreadPool pool(options.parallel ? 1 : std::min(paths.size(), workers));
+        std::vector<std::future<void>> pending;
+        pending.reserve(paths.size());
+        for (std::size_t file = 0; file < paths.size(); ++file) {
+            pending.push_back(pool.submit([&, file]() {
+                auto agency = std::make_unique<TravelAgency>();
+                loadFile(*agency, paths[file], options);
+                loaded[file] = std::move(agency);
+            }));
+        }
+        // Report the first failing file in argument order, after all loads have finished.
+        std::string error;
+        for (std::size_t file = 0; file < paths.size(); ++file) {
+            try {
+                pending[file].get();
+            } catch (const std::exception &ex) {
+                if (error.empty()) {
+                    error = paths[file] + ": " + ex.what();
+                }
+            }
+        }
+        if (!error.empty()) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+    }
+
+    TravelAgency agency;
+    for (std::size_t file = 0; file < paths.size(); ++file) {
+        try {
+            agency.merge(*loaded[file]);
+        } catch (const std::exception &ex) {
+            std::cerr << paths[file] << ": " << ex.what() << "\n";
+            return 1;
+        }
+    }
+
+    if (details) {
+        agency.printAllDetails();
+    }
+    if (statistics) {
+        agency.printStatistics();
+    }
+    if (metrics) {
+        // One JSON object per line and file, in argument order.
+        for (std::size_t file = 0; file < paths.size(); ++file) {
+            std::cout << "{\"file\":" << nlohmann::json(paths[file]).dump()
+                      << ",\"metrics\":" << loaded[file]->loadMetrics().toJson() << "}\n";
+        }
+    }
+    return 0;
+}
+
+// TravelAgency --stream [--details] [--statistics] [--check-ids] <datei.bin>
+// Prints the report of a binary file without loading it; without an output option both parts
+// are printed.
+int printStreamingReport(int argc, char *argv[]) {
+    StreamingReportOptions options;
+    bool details = false;
+    bool statistics = false;
+    std::string path;
+    for (int i = 2; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (argument == "--details") {
+            details = true;
+        } else if (argument == "--statistics") {
+            statistics = true;
+        } else if (argument == "--check-ids") {
+            options.checkDuplicateIds = true;
+        } else if (argument.compare(0, 2, "--") != 0 && path.empty()) {
+            path = argument;
+        } else {
+            path.clear();
+            break;
+        }
+    }
+    if (path.empty()) {
+        std::cerr << "Verwendung: " << argv[0] << " --stream [--details] [--statistics] [--check-ids] <datei.bin>\n";
+        return 2;
+    }
+    if (details || statistics) {
+        options.details = details;
+        options.statistics = statistics;
+    }
+    try {
+        ReportWriter out(std::cout);
+        streamBinaryReport(path, out, options);
+    } catch (const std::exception &ex) {
+        std::cout.flush();
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--convert") {
+        return convertJsonToBinary(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--export") {
+        return exportBookingsTo(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--group-by") {
+        return printGroupReport(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--metrics") {
+        return printLoadMetrics(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--batch") {
+        return runBatch(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--stream") {
+        return printStreamingReport(argc, argv);
+    }
 
-int main() {
+    // TravelAgency [--snapshot]
+    // Interactive menu. With --snapshot a JSON file is loaded through "<datei>.snapshot", which is
+    // written next to it when missing or stale.
+    const bool useSnapshot = argc > 1 && std::string(argv[1]) == "--snapshot";
     TravelAgency agency;
 
     while (true) {
@@ -31,7 +315,9 @@ int main() {
                     path = "bookings.json";
                 }
                 try {
-                    agency.readFile(path);
+                    LoadOptions options;
+                    options.useSnapshot = useSnapshot;
+                    agency.readFile(path, options);
                     break;
                 } catch (const std::exception &ex) {
                     std::cerr << ex.what() << "\n";
@@ -0,0 +1,111 @@
+// Round trip of bookings with non-ASCII text from a binary file through writeJsonFile and readFile.
+//
+//   ExportRoundTripTest <scratch directory>
+//
+// Exits with 0 if UTF-8 text reads back unchanged and Latin-1 text fails the export before the
+// output file is created; prints what went wrong to stderr otherwise.
+
+#include "BinaryBookingReader.h"
+#include "ReportWriter.h"
+#include "TravelAgency.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+int failures = 0;
+
+void expect(bool condition, const std::string &message) {
+    if (!condition) {
+        std::cerr << "FAILED: " << message << "\n";
+        ++failures;
+    }
+}
+
+void appendSlot(std::string &record, const std::string &value, std::size_t length) {
+    record.append(value);
+    record.append(length - value.size(), ' ');
+}
+
+// One fixed-width hotel record as read by readBinaryRecord.
+std::string hotelRecord(const std::string &id, const std::string &hotel, const std::string &city) {
+    std::string record = "H";
+    appendSlot(record, id, kBinaryIdLength);
+    const double price = 123.45;
+    char bytes[sizeof(double)];
+    std::memcpy(bytes, &price, sizeof(double));
+    record.append(bytes, sizeof(double));
+    record.append("20240101").append("20240105");
+    appendSlot(record, hotel, kBinaryTextLength);
+    appendSlot(record, city, kBinaryTextLength);
+    return record;
+}
+
+void writeFile(const std::filesystem::path &path, const std::string &content) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << content;
+}
+
+std::string details(const TravelAgency &agency) {
+    std::string text;
+    {
+        ReportWriter out(text);
+        agency.printAllDetails(out);
+    }
+    return text;
+}
+
+void utf8RoundTrip(const std::filesystem::path &dir) {
+    const auto binary = dir / "utf8.bin";
+    const auto json = dir / "utf8.json";
+    writeFile(binary, hotelRecord("11111111-aaaa-4bbb-8ccc-000000000001", "H\xc3\xb4tel \xc3\x84", "M\xc3\xbcnchen") +
+                          hotelRecord("11111111-aaaa-4bbb-8ccc-000000000002", "\xe2\x82\xac Inn", "K\xc3\xb8" "benhavn"));
+
+    TravelAgency original;
+    original.readBinaryFile(binary.string());
+    original.writeJsonFile(json.string());
+    TravelAgency readBack;
+    readBack.readFile(json.string());
+    expect(readBack.size() == original.size(), "UTF-8 export reads back every booking");
+    expect(details(readBack) == details(original), "UTF-8 text reads back unchanged");
+}
+
+void latin1IsRejected(const std::filesystem::path &dir) {
+    const auto binary = dir / "latin1.bin";
+    const auto json = dir / "latin1.json";
+    writeFile(binary, hotelRecord("22222222-aaaa-4bbb-8ccc-000000000001", "Hotel\xe4", "M\xfcnchen"));
+    std::filesystem::remove(json);
+
+    TravelAgency agency;
+    agency.readBinaryFile(binary.string());
+    bool rejected = false;
+    try {
+        agency.writeJsonFile(json.string());
+    } catch (const std::runtime_error &ex) {
+        rejected = std::string(ex.what()).find("UTF-8") != std::string::npos;
+    }
+    expect(rejected, "Latin-1 text fails the JSON export");
+    expect(!std::filesystem::exists(json), "a failed JSON export creates no file");
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <scratch directory>\n";
+        return 2;
+    }
+    const std::filesystem::path dir(argv[1]);
+    std::filesystem::create_directories(dir);
+    try {
+        utf8RoundTrip(dir);
+        latin1IsRejected(dir);
+    } catch (const std::exception &ex) {
+        std::cerr << "FAILED: " << ex.what() << "\n";
+        ++failures;
+    }
+    return failures == 0 ? 0 : 1;
+}